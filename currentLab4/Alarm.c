@@ -0,0 +1,167 @@
+// -------------------------------------------------------------------
+// File name: Alarm.c
+// Description: Alarm scheduler on a hashed timer wheel. Holds daily alarms,
+//              one-shot alarms and countdown/snooze timers; each second of
+//              the clock visits a single wheel slot to find what is due.
+//              Entries hash on their due second; an entry further away than
+//              one turn of the wheel counts down the turns it still has to
+//              wait. WHEELSIZE divides ALARM_DAY so slots stay aligned when
+//              the dial wraps. Unused entries are kept on a free list, so
+//              adding one does not search the pool.
+//------------------------------------------------------------------------------
+#include <stdint.h>
+#include "Alarm.h"
+
+#define WHEELSIZE  64           // must be a power of 2 that divides ALARM_DAY
+#define CATCHUP    120          // longest gap Alarm_Tick will step through
+#define NONE       0xFFFF
+#define FREE       0
+
+typedef struct alarm_t {
+  uint16_t at;                  // second of the dial it goes off
+  uint16_t rounds;              // wheel turns left before it is due
+  uint16_t next;                // next entry in the same slot or on the free list, NONE ends
+  uint8_t  type;                // FREE, ALARM_DAILY or ALARM_ONESHOT
+} alarm_t;
+
+static alarm_t Alarms[ALARM_MAX];
+static uint16_t Wheel[WHEELSIZE];   // first entry of each slot
+static uint16_t Free;               // first unused entry
+static int LastTick;                // last second processed
+uint32_t Alarm_Visits;
+uint32_t Alarm_MaxVisits;
+
+// put entry i in the wheel, due delta seconds after LastTick (1 to ALARM_DAY)
+static void Insert(int i, int delta){
+  int slot = (LastTick + delta) & (WHEELSIZE-1);
+  Alarms[i].rounds = (delta - 1)/WHEELSIZE;
+  Alarms[i].next = Wheel[slot];
+  Wheel[slot] = i;
+}
+
+// seconds from LastTick until the dial next shows at, 1 to ALARM_DAY
+static int Until(int at){
+  int delta = (at - LastTick + ALARM_DAY)%ALARM_DAY;
+  return delta ? delta : ALARM_DAY;
+}
+
+static int NewEntry(int at, uint8_t type){
+  int i = Free;
+  if(i == NONE){
+    return -1;
+  }
+  Free = Alarms[i].next;
+  Alarms[i].at = at;
+  Alarms[i].type = type;
+  return i;
+}
+
+static void FreeEntry(int i){
+  Alarms[i].type = FREE;
+  Alarms[i].next = Free;
+  Free = i;
+}
+
+// rebuild every slot list relative to now, after the clock was set
+static void Rebase(int now){
+  LastTick = now;
+  for(int s = 0; s < WHEELSIZE; s++){
+    Wheel[s] = NONE;
+  }
+  for(int i = 0; i < ALARM_MAX; i++){
+    if(Alarms[i].type != FREE){
+      Insert(i, Until(Alarms[i].at));
+    }
+  }
+}
+
+// process the entries hashed to one slot, for the second LastTick
+static int Visit(int slot){
+  uint16_t *link = &Wheel[slot];
+  int fired = 0;
+  uint32_t visits = 0;
+  while(*link != NONE){
+    alarm_t *a = &Alarms[*link];
+    int i = *link;
+    visits++;
+    if(a->rounds){
+      a->rounds--;              // due on a later turn
+      link = &a->next;
+      continue;
+    }
+    *link = a->next;            // unlink, then fire
+    fired++;
+    if(a->type == ALARM_DAILY){
+      Insert(i, ALARM_DAY);     // goes to the head, not seen again this pass
+      if(link == &Wheel[slot]){
+        link = &Alarms[i].next;
+      }
+    } else{
+      FreeEntry(i);
+    }
+  }
+  Alarm_Visits += visits;
+  if(visits > Alarm_MaxVisits){
+    Alarm_MaxVisits = visits;
+  }
+  return fired;
+}
+
+void Alarm_Init(int now){
+  now = now%ALARM_DAY;
+  Free = NONE;
+  for(int i = ALARM_MAX-1; i >= 0; i--){
+    FreeEntry(i);
+  }
+  Rebase(now);
+}
+
+int Alarm_Add(int at, uint8_t type){
+  int i;
+  at = ((at%ALARM_DAY) + ALARM_DAY)%ALARM_DAY;
+  i = NewEntry(at, type);
+  if(i >= 0){
+    Insert(i, Until(at));
+  }
+  return i;
+}
+
+int Alarm_After(int seconds){
+  int i;
+  if(seconds < 1) seconds = 1;
+  if(seconds > ALARM_DAY) seconds = ALARM_DAY;
+  i = NewEntry((LastTick + seconds)%ALARM_DAY, ALARM_ONESHOT);
+  if(i >= 0){
+    Insert(i, seconds);
+  }
+  return i;
+}
+
+void Alarm_Remove(int id){
+  uint16_t *link;
+  if((id < 0) || (id >= ALARM_MAX) || (Alarms[id].type == FREE)) return;
+  link = &Wheel[Alarms[id].at & (WHEELSIZE-1)];
+  while(*link != NONE){
+    if(*link == id){
+      *link = Alarms[id].next;
+      break;
+    }
+    link = &Alarms[*link].next;
+  }
+  FreeEntry(id);
+}
+
+int Alarm_Tick(int now){
+  int fired = 0, gap;
+  now = now%ALARM_DAY;
+  gap = (now - LastTick + ALARM_DAY)%ALARM_DAY;
+  if(gap > CATCHUP){
+    Rebase(now);                // clock was set, nothing in between is real
+    return 0;
+  }
+  while(LastTick != now){
+    LastTick = (LastTick + 1)%ALARM_DAY;
+    fired += Visit(LastTick & (WHEELSIZE-1));
+  }
+  return fired;
+}
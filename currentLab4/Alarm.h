@@ -0,0 +1,49 @@
+// -------------------------------------------------------------------
+// File name: Alarm.h
+// Description: Alarm scheduler on a hashed timer wheel. Holds daily alarms,
+//              one-shot alarms and countdown/snooze timers; each second of
+//              the clock visits a single wheel slot to find what is due.
+//------------------------------------------------------------------------------
+#include <stdint.h>
+
+#define ALARM_DAY      43200    // the clock runs on a 12 hour dial
+#define ALARM_MAX      512      // alarms and timers that can be pending, 8 bytes each
+#define ALARM_DAILY    1        // goes off at the same time every turn of the dial
+#define ALARM_ONESHOT  2        // goes off once, then is removed
+
+// wheel entries examined since reset and the most in a single second
+extern uint32_t Alarm_Visits;
+extern uint32_t Alarm_MaxVisits;
+
+//------------Alarm_Init------------
+// Remove every alarm and start the wheel at the current time
+// Input: now, clock time in seconds (0 to ALARM_DAY-1)
+// Output: none
+void Alarm_Init(int now);
+
+//------------Alarm_Add------------
+// Schedule an alarm at a time of day
+// Input: at time in seconds (0 to ALARM_DAY-1), type ALARM_DAILY or ALARM_ONESHOT
+// Output: id to pass to Alarm_Remove, -1 if all ALARM_MAX entries are in use
+int Alarm_Add(int at, uint8_t type);
+
+//------------Alarm_After------------
+// Schedule a one-shot countdown or snooze timer
+// Input: seconds from now (1 to ALARM_DAY)
+// Output: id to pass to Alarm_Remove, -1 if all ALARM_MAX entries are in use
+int Alarm_After(int seconds);
+
+//------------Alarm_Remove------------
+// Cancel an alarm, ids of alarms that already went off are ignored
+// Input: id from Alarm_Add or Alarm_After, negative ids are ignored
+// Output: none
+void Alarm_Remove(int id);
+
+//------------Alarm_Tick------------
+// Advance the wheel to the current time, once per second. Every second the
+// caller skipped is still processed, so no deadline is missed. A jump of
+// more than two minutes (the clock was set) reschedules instead of firing
+// everything in between.
+// Input: now, clock time in seconds (0 to ALARM_DAY-1)
+// Output: number of alarms that went off
+int Alarm_Tick(int now);
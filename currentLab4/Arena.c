@@ -0,0 +1,47 @@
+// -------------------------------------------------------------------
+// File name: Arena.c
+// Description: One static block of RAM handed out in order, see Arena.h
+//------------------------------------------------------------------------------
+#include <stdint.h>
+#include "Arena.h"
+
+static uint32_t ArenaMem[ARENA_SIZE/4];   // words, so every buffer is aligned
+uint32_t Arena_Used;
+uint32_t Arena_Peak;
+uint32_t Arena_Failed;
+uint32_t Arena_PhasePeak[ARENA_PHASES];
+static uint32_t Phase = ARENA_BOOT;
+
+void *Arena_Alloc(uint32_t bytes){
+  void *pt;
+  bytes = (bytes + 3) & ~3u;
+  if(bytes > ARENA_SIZE - Arena_Used){
+    Arena_Failed++;
+    return 0;
+  }
+  pt = (uint8_t *)ArenaMem + Arena_Used;
+  Arena_Used += bytes;
+  if(Arena_Used > Arena_Peak){
+    Arena_Peak = Arena_Used;
+  }
+  if(Arena_Used > Arena_PhasePeak[Phase]){
+    Arena_PhasePeak[Phase] = Arena_Used;
+  }
+  return pt;
+}
+
+void Arena_Phase(uint32_t phase){
+  if(phase < ARENA_PHASES){
+    Phase = phase;
+  }
+}
+
+uint32_t Arena_Mark(void){
+  return Arena_Used;
+}
+
+void Arena_Release(uint32_t mark){
+  if(mark < Arena_Used){
+    Arena_Used = mark;
+  }
+}
@@ -0,0 +1,50 @@
+// -------------------------------------------------------------------
+// File name: Arena.h
+// Description: One static block of RAM for scratch buffers that live only
+//              inside one call from the main loop. The line bitmap in
+//              Text.c, the face band in Clock.c and the tile image in
+//              Tiles.c are never needed at the same time, so they take
+//              turns in the same bytes. A caller takes its buffer with
+//              Arena_Mark and Arena_Alloc and gives it back with
+//              Arena_Release before it returns, and copes with a 0 from
+//              Arena_Alloc. Interrupt handlers must not use the arena.
+//              The peak is also kept for each phase of the run, boot,
+//              ESP8266 setup and link up, as main moves through them.
+//------------------------------------------------------------------------------
+#include <stdint.h>
+
+#define ARENA_SIZE 1056     // bytes, an 11 character line bitmap in Text.c
+
+#define ARENA_BOOT   0      // power-on to the first frame
+#define ARENA_SETUP  1      // ESP8266 bring-up
+#define ARENA_RUN    2      // link up
+#define ARENA_PHASES 3
+
+// bytes in use now, the most ever in use, and allocations that did not fit
+extern uint32_t Arena_Used;
+extern uint32_t Arena_Peak;
+extern uint32_t Arena_Failed;
+// the most in use during each ARENA_xxx phase
+extern uint32_t Arena_PhasePeak[ARENA_PHASES];
+
+//------------Arena_Phase------------
+// Charge the peaks from now on to a phase of the run
+// Input: phase ARENA_xxx
+// Output: none
+void Arena_Phase(uint32_t phase);
+
+//------------Arena_Alloc------------
+// Take a buffer from the arena
+// Input: bytes size, rounded up to a multiple of 4
+// Output: 4-byte aligned buffer, 0 if it does not fit
+void *Arena_Alloc(uint32_t bytes);
+
+//------------Arena_Mark------------
+// Output: the current fill, to hand to Arena_Release later
+uint32_t Arena_Mark(void);
+
+//------------Arena_Release------------
+// Give back every buffer taken since mark
+// Input: mark from Arena_Mark
+// Output: none
+void Arena_Release(uint32_t mark);
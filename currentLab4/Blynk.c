@@ -35,8 +35,6 @@
 // Use LM2937-3.3 and two 4.7 uF capacitors to convert USB +5V to 3.3V for the ESP8266
 // http://www.ti.com/lit/ds/symlink/lm2937-3.3.pdf
 #include <stdint.h>
-#include <string.h>
-#include <stdlib.h>
 #include "tm4c123gh6pm.h"
 #include "ST7735.h"
 #include "PLL.h"
@@ -45,10 +43,22 @@
 #include "UART.h"
 #include "PortF.h"
 #include "esp8266.h"
-#include "LCD.h"
+#include "Clock.h"
+#include "Display.h"
+#include "Digits.h"
+#include "Timebase.h"
+#include "Alarm.h"
 #include "Timer.h"
 #include "Systick.h"
 #include "Speaker.h"
+#include "Event.h"
+#include "Profile.h"
+#include "Eeprom.h"
+#include "Settings.h"
+#include "Frame.h"
+#include "History.h"
+#include "Arena.h"
+#include "Fill.h"
 
 #define Factory_Time (8*3600 +46*60) - 25
 #define Factory_Alarm (8*3600 +46*60) + 60
@@ -59,146 +69,434 @@ void WaitForInterrupt(void);    // Defined in startup.s
 long StartCritical (void);    // previous I bit, disable interrupts
 void EndCritical(long sr);    // restore I bit to previous value
 void ButtonControl(uint32_t value, uint32_t button_num);
-void PhaseControl(uint32_t phase, uint32_t tempTime);
+void ButtonRepeat(void);
+void ButtonFlush(void);
+void PhaseControl(uint32_t phase, int tempTime);
 void CheckInactiveTime(void);
+void ClockTick(void);
+void ShowClock(int t, int face);
+void Blynk_Receive(void);
 void ResetToFactory(int isResetToFactory);
+char *FormatUDec(char *pt, uint32_t n);
 void PortD_Init(void);
+void SaveSettings(void);
+uint32_t History_Upload(void);
+void PublishState(void);
+void SoundAlarm(void);
+void RestoreSettings(void);
 
 uint32_t LED;      // VP1
-uint32_t LastF;    // VP74
-// These 6 variables contain the most recent Blynk to TM4C123 message
+uint32_t AlarmMelody;   // VP8, 0 beeps, 1 chime, 2 quarters
+// Receive ring between the Timer2 ISR (only producer) and the main loop (only
+// consumer). ESP8266_GetMessage writes straight into the next free slot and the
+// main loop parses it in place, so there are no intermediate copies or locks.
 // Blynk to TM4C123 uses VP0 to VP15
-char serial_buf[64];
-char Pin_Number[2]   = "99";       // Initialize to invalid pin number
-char Pin_Integer[8]  = "0000";     //
-char Pin_Float[8]    = "0.0000";   //
-uint32_t pin_num; 
+#define RXSLOTS     4           // must be a power of 2
+#define RXSLOTSIZE  64
+char RxRing[RXSLOTS][RXSLOTSIZE];
+volatile uint32_t RxPutI;       // slots written, only changed by Timer2 ISR
+volatile uint32_t RxGetI;       // slots parsed, only changed by main
+// These 3 variables contain the most recent Blynk to TM4C123 message
+uint32_t pin_num = 99;          // Initialize to invalid pin number
 uint32_t pin_int;
+int32_t pin_fixed;              // float field in units of 0.001
 extern int time, secFlag;
 extern char sec[], min[], hour[];
 char sec_sw[2], min_sw[2];
 extern uint32_t h,m,s;
 int temp_t;
 extern int time_alarm, alarm, inAlarm;
-int lastTimePressed, timeInactive = 0, time_sw = 0, time_d = 0;
-int sw_flag = 0, reset_flag = 0, d_flag = 0, isResetToFactory = 0, default_phase = 0;
+void setAlarm(int t);           // Defined in Speaker.c
+void Speaker_Play(uint32_t m);  // Defined in Speaker.c
+void Speaker_Stop(void);        // Defined in Speaker.c
+uint64_t lastTimePressed;        // Timebase tick of the last Blynk button
+uint32_t time_sw = 0;            // stopwatch reading in ms
+uint64_t sw_start, sw_stopped;   // tick the stopwatch read 0, ticks counted when stopped
+uint32_t HeldButton;             // VP2 or VP3 while held on a field, 0 if none
+volatile uint32_t PendingPresses; // field presses drained but not yet applied
+volatile int FrameRequest = 0;   // 1 while the stopwatch or a held button needs EVENT_FRAME
+int sw_flag = 0, reset_flag = 0, isResetToFactory = 0, default_phase = 0;
 
+// Performance counters, read with the debugger
+#define PHASES 7
+uint32_t LoopCount;              // main loop iterations
+uint32_t PhaseBytes[PHASES];     // ST7735 bytes drained while in each phase
+uint32_t PhaseFrames[PHASES];    // PhaseControl passes in each phase
+uint32_t VpLatencyLast, VpLatencyMax;  // us from a VP message to the screen caught up
+uint64_t VpStamp;                // tick the oldest unfinished message arrived, 0 if none
+uint64_t ClockNext;              // timebase tick of the next second of time
 
+
+// Each phase is a small set of retained widgets: widget i is option/field i,
+// drawn in color[i]. ButtonControl marks the widgets it changes in dirty and
+// PhaseControl only pushes those to the ST7735, then clears the bits.
+#define DIRTY_ALL     0xFF  // every widget, used after the screen is cleared
+#define DIRTY_STATIC  0x80  // fixed decorations such as the ':' separators
+#define SW_TIMER      3     // phase 4 widget that holds the stopwatch reading
 typedef struct phase_t {
 	char *options[5];
 	int time[3];
 	int8_t  highlight;    // index (out of total)l; -1 for none
 	int color[6];     
 	uint8_t selected;      // 0 for not selected. 1 for selected
+	uint8_t dirty;         // bit i set when widget i must be redrawn
 } phase;
 
 phase phases[7] = {
-   {{"\n"}, {'\n'}, -1, {'\n'}, 0},  													// phase 0: clock display
-   {{"Set Clock", "Set Alarm", "Back", "Stop Watch"}, {'\n'}, 0, {ST7735_YELLOW,ST7735_WHITE,ST7735_WHITE, ST7735_WHITE}, 0},   // phase 1: select menu
-   {{"Set", "Back"}, {0, 0, 0}, 2, {ST7735_WHITE,ST7735_WHITE,ST7735_YELLOW,ST7735_WHITE,ST7735_WHITE}, 0},               // phase 2: set time
-   {{"Set", "Back"}, {0, 0, 0}, 2, {ST7735_WHITE,ST7735_WHITE,ST7735_YELLOW,ST7735_WHITE,ST7735_WHITE}, 0},	              // phase 3: set alarm
-	 {{"Start", "Pause", "Back"}, {0, 0, 0}, 0, {ST7735_WHITE,ST7735_WHITE,ST7735_WHITE,ST7735_WHITE,ST7735_WHITE,ST7735_YELLOW}, 0}, 	// phase 4: stop watch display
-	 {{"\n"}, {'\n'}, -1, {'\n'}, 0},  													// phase 5: clock display 2
-	 {{"\n"}, {'\n'}, -1, {'\n'}, 0},  													// phase 6: clock display 3
+   {{"\n"}, {'\n'}, -1, {'\n'}, 0, 0},  												// phase 0: clock display
+   {{"Set Clock", "Set Alarm", "Back", "Stop Watch"}, {'\n'}, 0, {ST7735_YELLOW,ST7735_WHITE,ST7735_WHITE, ST7735_WHITE}, 0, DIRTY_ALL},   // phase 1: select menu
+   {{"Set", "Back"}, {0, 0, 0}, 2, {ST7735_WHITE,ST7735_WHITE,ST7735_YELLOW,ST7735_WHITE,ST7735_WHITE}, 0, DIRTY_ALL},               // phase 2: set time
+   {{"Set", "Back"}, {0, 0, 0}, 2, {ST7735_WHITE,ST7735_WHITE,ST7735_YELLOW,ST7735_WHITE,ST7735_WHITE}, 0, DIRTY_ALL},	              // phase 3: set alarm
+	 {{"Start", "Pause", "Back"}, {0, 0, 0}, 0, {ST7735_WHITE,ST7735_WHITE,ST7735_WHITE,ST7735_WHITE,ST7735_WHITE,ST7735_YELLOW}, 0, DIRTY_ALL}, 	// phase 4: stop watch display
+	 {{"\n"}, {'\n'}, -1, {'\n'}, 0, 0},  												// phase 5: clock display 2
+	 {{"\n"}, {'\n'}, -1, {'\n'}, 0, 0},  												// phase 6: clock display 3
 };
 uint8_t phase_num = 0;
+void RenderSetTime(phase *p);
+void MoveHighlight(phase *p, int8_t next);
+void ClearScreen(void);
+
+// ------------------------------ Virtual pin table -------------------------------
+// One entry per virtual pin VP0-VP99, filled in at compile time so the table is
+// in flash. An inbound pin names the handler called with its message and an
+// optional context pointer. Outbound pins 70-99 point context at a vp_out_t in
+// RAM that holds the value to publish and the value last sent to the app.
+#define VP_COUNT      100
+#define VP_OUT_FIRST  70
+#define VP_PROFILE    80    // VP80-VP91 cycle counts, see SendInformation
+#define VP_FRAMING    98    // 1 offers binary records (Frame.h) to the ESP8266
+#define VP_NEVER      0xFFFFFFFF  // value and sent of a pin never written
+typedef void (*vp_handler_t)(uint32_t pin, uint32_t value, int32_t fixed, void *context);
+typedef struct vp_entry_t {
+  vp_handler_t handler;    // 0 if nothing listens on this pin
+  void *context;           // passed to handler, or the vp_out_t of an outbound pin
+} vp_entry_t;
+typedef struct vp_out_t {
+  uint32_t value;          // current value
+  uint32_t sent;           // value most recently sent to the Blynk App
+} vp_out_t;
+
+void VP_Select(uint32_t pin, uint32_t value, int32_t fixed, void *context);
+void VP_Button(uint32_t pin, uint32_t value, int32_t fixed, void *context);
+void VP_Alarm(uint32_t pin, uint32_t value, int32_t fixed, void *context);
+void VP_Set(uint32_t pin, uint32_t value, int32_t fixed, void *context);
+
+vp_out_t VpOut[VP_COUNT-VP_OUT_FIRST];
+#define VP_OUT(n) [n] = {0, &VpOut[(n)-VP_OUT_FIRST]}
+const vp_entry_t VirtualPins[VP_COUNT] = {
+  [0] = {&VP_Button, 0},    // FACTORY
+  [1] = {&VP_Select, &LED}, // SELECT, also drives the blue LED
+  [2] = {&VP_Button, 0},    // SCROLL DOWN
+  [3] = {&VP_Button, 0},    // SCROLL UP
+  [4] = {&VP_Button, 0},    // MODE
+  [5] = {&VP_Alarm, 0},     // ALARM time, seconds since midnight (Time Input widget)
+  [6] = {&VP_Alarm, 0},     // COUNTDOWN timer, seconds from now
+  [7] = {&VP_Alarm, 0},     // SNOOZE, minutes from now (0 for 5)
+  [8] = {&VP_Set, &AlarmMelody},  // MELODY of the alarm
+  VP_OUT(70), VP_OUT(71), VP_OUT(72), VP_OUT(73), VP_OUT(74),
+  VP_OUT(75), VP_OUT(76), VP_OUT(77), VP_OUT(78), VP_OUT(79),
+  VP_OUT(80), VP_OUT(81), VP_OUT(82), VP_OUT(83), VP_OUT(84),
+  VP_OUT(85), VP_OUT(86), VP_OUT(87), VP_OUT(88), VP_OUT(89),
+  VP_OUT(90), VP_OUT(91), VP_OUT(92), VP_OUT(93), VP_OUT(94),
+  VP_OUT(95), VP_OUT(96), VP_OUT(97), VP_OUT(98), VP_OUT(99)
+};
+
+// ------------------------------ VP_Button ---------------------------------------
+// Handler for the menu buttons, the pin number is the button number
+void VP_Button(uint32_t pin, uint32_t value, int32_t fixed, void *context){
+  (void)fixed; (void)context;
+  ButtonControl(value, pin);
+}
+
+// ------------------------------ VP_Alarm ----------------------------------------
+// Handler for the alarm pins VP5-VP7, see the table above
+void VP_Alarm(uint32_t pin, uint32_t value, int32_t fixed, void *context){
+  (void)fixed; (void)context;
+  if(pin == 5){
+    setAlarm(value % ALARM_DAY);
+  }
+  else if(pin == 6){
+    if(value) Alarm_After(value);
+  }
+  else{
+    Alarm_After(60*(value ? value : 5));
+    inAlarm = 0;                      // quiet until the snooze is over
+  }
+}
+
+// ------------------------------ VP_Set ------------------------------------------
+// Handler for pins that only set a variable, given as context
+void VP_Set(uint32_t pin, uint32_t value, int32_t fixed, void *context){
+  (void)pin; (void)fixed;
+  *(uint32_t *)context = value;
+}
+
+// ------------------------------ VP_Select ---------------------------------------
+// Handler for VP1, stores the value in the LED variable given as context
+void VP_Select(uint32_t pin, uint32_t value, int32_t fixed, void *context){
+  (void)fixed;
+  *(uint32_t *)context = value;
+  PortF_Output(value<<2); // Blue LED
+  ButtonControl(value, pin);
+#ifdef DEBUG3
+ //     Output_Color(ST7735_CYAN);
+ //     ST7735_OutString("Rcv VP1 data=");
+ //     ST7735_OutUDec(LED);
+ //     ST7735_OutChar('\n');
+#endif
+}
+
+// ----------------------------------- FormatUDec --------------------------------
+// Write n in decimal at pt, no terminator
+// Output: pointer just past the last digit
+char *FormatUDec(char *pt, uint32_t n){ char digits[10]; int i = 0;
+  do{
+    digits[i++] = '0' + n%10;
+    n = n/10;
+  }while(n);
+  while(i){
+    *pt++ = digits[--i];
+  }
+  return pt;
+}
+
+// ----------------------------------- VP_Init -----------------------------------
+// Mark every outbound pin as never written and never sent. The two match, so
+// a pin stays out of the flush until VP_Write gives it a value.
+void VP_Init(void){
+  for(int i = 0; i < VP_COUNT-VP_OUT_FIRST; i++){
+    VpOut[i].value = VP_NEVER;
+    VpOut[i].sent = VP_NEVER;
+  }
+}
+
+// ----------------------------------- VP_Write ----------------------------------
+// Set the value of an outbound Virtual Pin (70 to 99); nothing is sent
+// until TM4C_to_Blynk is called
+void VP_Write(uint32_t pin, uint32_t value){ vp_out_t *out;
+  if((pin < VP_OUT_FIRST)||(pin >= VP_COUNT)){
+    return; // ignore illegal requests
+  }
+  out = VirtualPins[pin].context;
+  out->value = value;
+}
 
 // ----------------------------------- TM4C_to_Blynk ------------------------------
 // Send data to the Blynk App
 // It uses Virtual Pin numbers between 70 and 99
 // so that the ESP8266 knows to forward the data to the Blynk App
-void TM4C_to_Blynk(uint32_t pin,uint32_t value){
-  if((pin < 70)||(pin > 99)){
-    return; // ignore illegal requests
+// Every outbound pin whose value changed since it was last sent is formatted
+// into one buffer as a "pin,value,0.0\n" record and the whole batch goes out
+// in one ESP8266_OutString; unchanged pins cost nothing. Once the ESP8266
+// has sent a binary record the batch is made of binary records instead.
+// Output: number of bytes sent
+#define TXFRAMESIZE 128
+char TxFrame[TXFRAMESIZE];
+uint32_t TxBytesLast;    // bytes sent by the last TM4C_to_Blynk
+uint32_t TxBytesTotal;   // bytes sent since reset
+volatile int FrameBinary; // 1 once the ESP8266 has answered in binary records
+uint32_t FrameBad;       // damaged binary records in a row
+uint32_t TM4C_to_Blynk(void){ vp_out_t *out; char *pt = TxFrame; uint32_t bytes = 0;
+  for(uint32_t pin = VP_OUT_FIRST; pin < VP_COUNT; pin++){
+    out = VirtualPins[pin].context;
+    if(out->value == out->sent) continue;
+    if((pt - TxFrame) > (TXFRAMESIZE - 20)){  // room for "99,4294967295,0.0\n" or FRAME_MAX
+      *pt = 0;
+      ESP8266_OutString(TxFrame);
+      bytes += pt - TxFrame;
+      pt = TxFrame;
+    }
+    if(FrameBinary){
+      pt = Frame_Encode(pt, pin, out->value);
+    } else{
+      pt = FormatUDec(pt, pin);       // Send the Virtual Pin #
+      *pt++ = ',';
+      pt = FormatUDec(pt, out->value);  // Send the current value
+      *pt++ = ',';
+      *pt++ = '0'; *pt++ = '.'; *pt++ = '0';  // Null value not used in this example
+      *pt++ = '\n';
+    }
+    out->sent = out->value;
   }
 // your account will be temporarily halted if you send too much data
-  ESP8266_OutUDec(pin);       // Send the Virtual Pin #
-  ESP8266_OutChar(',');
-  ESP8266_OutUDec(value);      // Send the current value
-  ESP8266_OutChar(',');
-  ESP8266_OutString("0.0\n");  // Null value not used in this example
+  if(pt != TxFrame){
+    *pt = 0;
+    ESP8266_OutString(TxFrame);
+    bytes += pt - TxFrame;
+  }
+  TxBytesLast = bytes;
+  TxBytesTotal += bytes;
+  return bytes;
 }
  
  
 // -------------------------   Blynk_to_TM4C  -----------------------------------
-// This routine receives the Blynk Virtual Pin data via the ESP8266 and parses the
-// data and feeds the commands to the TM4C.
-void Blynk_to_TM4C(void){int j; char data;
-// Check to see if a there is data in the RXD buffer
-  if(ESP8266_GetMessage(serial_buf)){  // returns false if no message
-    // Read the data from the UART5
-#ifdef DEBUG1
-    j = 0;
-    do{
-      data = serial_buf[j];
-      UART_OutChar(data);        // Debug only
-      j++;
-    }while(data != '\n');
-    UART_OutChar('\r');        
-#endif
-           
-// Rip the 3 fields out of the CSV data. The sequence of data from the 8266 is:
-// Pin #, Integer Value, Float Value.
-    strcpy(Pin_Number, strtok(serial_buf, ","));
-    strcpy(Pin_Integer, strtok(NULL, ","));       // Integer value that is determined by the Blynk App
-    strcpy(Pin_Float, strtok(NULL, ","));         // Not used
-    pin_num = atoi(Pin_Number);     // Need to convert ASCII to integer
-    pin_int = atoi(Pin_Integer);  
-  // ---------------------------- VP #1 ----------------------------------------
-  // This VP is the LED select button
-    if(pin_num == 0x01)  {  //SELECT
-      LED = pin_int;
-      PortF_Output(LED<<2); // Blue LED
-			int temp = pin_int;
-			ButtonControl(temp, 1);
-			
-#ifdef DEBUG3
- //     Output_Color(ST7735_CYAN);
- //     ST7735_OutString("Rcv VP1 data=");
- //     ST7735_OutUDec(LED);
- //     ST7735_OutChar('\n');
-#endif
-    }                               // Parse incoming data   
-// ---------------------------- VP #2 ----------------------------------------
-			if(pin_num == 0x02)  {	//SCROLL DOWN
-				int temp = pin_int;
-				ButtonControl(temp, 2);
-			}
-// ---------------------------- VP #3 ----------------------------------------
-			if(pin_num == 0x03)  {	//SCROLL UP
-				int temp = pin_int;
-				ButtonControl(temp, 3);
-			}
-// ---------------------------- VP #4 ----------------------------------------
-			if(pin_num == 0x04)  {	//MODE
-				int temp = pin_int;
-				ButtonControl(temp, 4);
-			}
-// ---------------------------- VP #0 ----------------------------------------
-			if(pin_num == 0x00)  {	//FACTORY
-				int temp = pin_int;
-				ButtonControl(temp, 0);
-			}
+// Runs in the Timer2 ISR every 10 ms. Moves a waiting Blynk message from the
+// ESP8266 into the receive ring and wakes the main loop to parse it. When the
+// ring is full the message stays queued in the ESP8266 driver until next time.
+// While the stopwatch runs it also wakes the main loop every 100 ms. Every
+// waiting message is moved at once, so a burst from the app is drained by
+// one Blynk_Receive; once a poll finds no new message the burst is over and
+// the field presses it held are applied as one step.
+void Blynk_to_TM4C(void){ static uint32_t frameCount;
+  uint32_t t0 = Profile_Start(), got = 0;
+  if(FrameRequest && (++frameCount >= 10)){  // 10 Hz stopwatch refresh and auto-repeat
+    frameCount = 0;
+    Event_Post(EVENT_FRAME, 0, 0);
+  }
+  while(((RxPutI - RxGetI) < RXSLOTS) && ESP8266_Connected() &&
+        ESP8266_GetMessage(RxRing[RxPutI & (RXSLOTS-1)])){  // returns false if no message
+    RxPutI++;
+    got++;
+  }
+  if(got){
+    Event_Post(EVENT_MESSAGE, 0, 0);
+  } else if(PendingPresses){
+    Event_Post(EVENT_FRAME, 0, 0);
+  }
+  Profile_Stop(PROF_RX, t0);
+}
+
+// -------------------------   Blynk_Parse  -------------------------------------
+// Single pass over the CSV data in place. The sequence of data from the 8266 is:
+// Pin #, Integer Value, Float Value, ended by '\n'
+// Input: pt points to the message, at most RXSLOTSIZE characters
+// Output: 1 with pin, integer and float (fixed point, 0.001 resolution) filled
+//         in, 0 if the message is malformed
+int Blynk_Parse(const char *pt, uint32_t *pin, uint32_t *integer, int32_t *fixed){
+  const char *end = pt + RXSLOTSIZE;
+  uint32_t n = 0;
+  int32_t whole = 0, frac = 0, scale = 1000, sign = 1;
+  if((*pt < '0') || (*pt > '9')) return 0;
+  while((pt < end) && (*pt >= '0') && (*pt <= '9')){
+    n = 10*n + (*pt++ - '0');
+  }
+  if((pt >= end) || (*pt++ != ',')) return 0;
+  *pin = n;
+  n = 0;
+  while((pt < end) && (*pt >= '0') && (*pt <= '9')){
+    n = 10*n + (*pt++ - '0');       // Integer value that is determined by the Blynk App
+  }
+  *integer = n;
+  if((pt < end) && (*pt == ',')){   // float is optional
+    pt++;
+    if((pt < end) && (*pt == '-')){
+      sign = -1;
+      pt++;
+    }
+    while((pt < end) && (*pt >= '0') && (*pt <= '9')){
+      whole = 10*whole + (*pt++ - '0');
+    }
+    if((pt < end) && (*pt == '.')){
+      pt++;
+      while((pt < end) && (*pt >= '0') && (*pt <= '9')){
+        if(scale > 1){                // digits past 0.001 are dropped
+          scale = scale/10;
+          frac = frac + scale*(*pt - '0');
+        }
+        pt++;
+      }
+    }
+  }
+  if((pt >= end) || ((*pt != '\n') && (*pt != '\r') && (*pt != 0))) return 0;
+  *fixed = sign*(1000*whole + frac);
+  return 1;
+}
+
+// -------------------------   Blynk_Receive  -----------------------------------
+// Called from the main loop on EVENT_MESSAGE. Parses every message waiting in
+// the receive ring and feeds the commands to the TM4C through VirtualPins.
+void Blynk_Receive(void){ char *msg; uint32_t t0;
+  while(RxGetI != RxPutI){
+    msg = RxRing[RxGetI & (RXSLOTS-1)];
 #ifdef DEBUG1
-//    UART_OutString(" Pin_Number = ");
-//    UART_OutString(Pin_Number);
-//    UART_OutString("   Pin_Integer = ");
-//    UART_OutString(Pin_Integer);
-//    UART_OutString("   Pin_Float = ");
-//    UART_OutString(Pin_Float);
-//    UART_OutString("\n\r");
+    for(int j = 0; (j < RXSLOTSIZE) && msg[j]; j++){
+      UART_OutChar(msg[j]);        // Debug only
+      if(msg[j] == '\n') break;
+    }
+    UART_OutChar('\r');
 #endif
-  }  
+    t0 = Profile_Start();
+    if((uint8_t)msg[0] & FRAME_FLAG){  // binary record, the ESP8266 took the offer
+      if(Frame_Decode(msg, RXSLOTSIZE, &pin_num, &pin_int)){
+        pin_fixed = 0;
+        FrameBinary = 1;
+        FrameBad = 0;
+      } else{
+        pin_num = 99;              // damaged, drop it
+        if(++FrameBad >= 4){
+          FrameBinary = 0;         // link looks wrong, go back to CSV
+        }
+      }
+    }
+    else if(Blynk_Parse(msg, &pin_num, &pin_int, &pin_fixed) == 0){
+      pin_num = 99;                // ignore garbage
+    }
+    Profile_Stop(PROF_PARSE, t0);
+    RxGetI++;                      // slot can be reused by the ISR
+    // one table lookup instead of comparing against every pin
+    if((pin_num < VP_OUT_FIRST) && VirtualPins[pin_num].handler){
+      VirtualPins[pin_num].handler(pin_num, pin_int, pin_fixed, VirtualPins[pin_num].context);
+    }
+  }
 }
 
-void SendInformation(void){
-  uint32_t thisF;
-  thisF = time;
-// your account will be temporarily halted if you send too much data
-  if(thisF != LastF){
-    TM4C_to_Blynk(74, thisF / 3600);  // VP74
-		TM4C_to_Blynk(75, (thisF % 3600) / 60);  // VP75
-		TM4C_to_Blynk(76, thisF % 60);  // VP76
+// ------------------------------ PublishState ----------------------------------
+// Clock state shared with the interrupt handlers. Main is the only writer:
+// it fills the copy the handlers are not reading and then flips ClockStateI
+// with one store. A handler cannot be interrupted by main, so the copy it
+// reads never changes under it and no interrupts are masked on either side.
+typedef struct clock_state_t {
+  int time, time_alarm, alarm, inAlarm;
+  uint32_t phase;
+  uint32_t gen;                 // counts publications
+} clock_state_t;
+clock_state_t ClockState[2];
+volatile uint32_t ClockStateI;  // index of the copy handlers read
+void PublishState(void){
+  clock_state_t *next = &ClockState[ClockStateI^1];
+  next->time = time;
+  next->time_alarm = time_alarm;
+  next->alarm = alarm;
+  next->inAlarm = inAlarm;
+  next->phase = phase_num;
+  next->gen = ClockState[ClockStateI].gen + 1;
+  ClockStateI ^= 1;
+}
+
+// ------------------------------ SoundAlarm ------------------------------------
+// Starts the melody chosen on VP8 when inAlarm is raised and stops it when
+// a button clears inAlarm
+void SoundAlarm(void){ static int sounding;
+  if(inAlarm != sounding){
+    sounding = inAlarm;
+    if(sounding){
+      Speaker_Play(AlarmMelody);
+    } else{
+      Speaker_Stop();
+    }
+  }
+}
+
+// Runs in the Timer3 ISR every 1/2 second; only the fields of the time that
+// changed are sent, as one batch. Nothing goes out while the ESP8266 is
+// being set up again after losing the server.
+void SendInformation(void){ static uint32_t profCount;
+  uint32_t thisF, t0;
+  if(!ESP8266_Connected()) return;
+  t0 = Profile_Start();
+  if(++profCount >= 20){       // every 10 s, VP80+2n mean and VP81+2n max cycles
+    profCount = 0;
+    for(uint32_t i = 0; i < PROF_REGIONS; i++){
+      VP_Write(VP_PROFILE + 2*i, Profile_Mean(i));
+      VP_Write(VP_PROFILE + 2*i + 1, Profile[i].max);
+    }
+  }
+  thisF = ClockState[ClockStateI].time;
+  VP_Write(74, thisF / 3600);  // VP74
+  VP_Write(75, (thisF % 3600) / 60);  // VP75
+  VP_Write(76, thisF % 60);  // VP76
+  if(TM4C_to_Blynk() + History_Upload()){
 #ifdef DEBUG3
     Output_Color(ST7735_WHITE);
    // ST7735_OutString("Send 74 data=");
@@ -206,216 +504,479 @@ void SendInformation(void){
     //ST7735_OutChar('\n');
 #endif
   }
-  LastF = thisF;
+  Profile_Stop(PROF_TX, t0);
+}
+
+// ------------------------------ Link_Step ------------------------------------
+// ESP8266 bring-up from the main loop once the screen is idle, so the clock is
+// drawn and keeps time from power-on. ESP8266_Reset and ESP8266_SetupWiFi busy
+// wait for 10 s and for as long as the module takes, so the driver's
+// ESP8266_Setup takes the same steps one call at a time, each wait a deadline
+// on the timebase that returns to the event loop. Timer2 and Timer3 talk to
+// the ESP8266, so they start once it is set up. The module raises RDY when
+// it loses the server; then it is reset and set up again. Nothing is sent
+// while it is down, so pins that changed meanwhile go out once it is back.
+#define LINK_INIT   0
+#define LINK_SETUP  1               // ESP8266_Setup until the module has joined
+#define LINK_START  2
+#define LINK_UP     3
+uint32_t LinkState = LINK_INIT;
+uint32_t LinkRetries;           // resets after the ESP8266 did not answer
+uint32_t LinkDrops;             // times the ESP8266 lost the server once up
+uint32_t FirstFrameMs;          // ms from power-on to the first clock frame
+uint32_t LinkUpMs;              // ms from power-on to the Blynk link up
+
+// Output: 1 if the state moved on and the next step can run right away,
+//         0 if it is waiting on the ESP8266 or a deadline
+int Link_Step(void){
+  uint32_t ms = Timebase_Ms(Timebase_Now());
+  switch(LinkState){
+    case LINK_INIT:
+      ESP8266_Begin(ms);        // Enable ESP8266 Serial Port, reset the module
+      LinkState = LINK_SETUP;
+      return 1;
+    case LINK_SETUP:
+      switch(ESP8266_Setup(ms)){
+        case ESP8266_STEPPED:
+          return 1;
+        case ESP8266_RETRY:
+          LinkRetries++;        // the ESP8266 timed out, it starts over
+          return 0;
+        case ESP8266_READY:
+          LinkState = LINK_START;
+          return 1;
+      }
+      return 0;
+    case LINK_START:
+      VP_Write(VP_FRAMING, 1);  // firmware that knows Frame.h answers in binary
+      LinkState = LINK_UP;
+      if(LinkDrops){
+        return 0;               // timers already running
+      }
+      Timer2_Init(&Blynk_to_TM4C,800000);
+      // check for receive data from Blynk App every 10ms
+      Timer3_Init(&SendInformation,40000000);
+      // Send data back to Blynk App every 1/2 second
+      LinkUpMs = Timebase_Ms(Timebase_Now());
+      Arena_Phase(ARENA_RUN);
+      if(phase_num == 0){
+        Display_FillRect(12, 40, 42, 8, ST7735_BLACK);  // erase "WiFi..."
+      }
+#ifdef DEBUG1
+      UART_OutString("first frame ms ");
+      UART_OutUDec(FirstFrameMs);
+      UART_OutString(", link up ms ");
+      UART_OutUDec(LinkUpMs);
+      UART_OutString(", arena peak bytes boot ");
+      UART_OutUDec(Arena_PhasePeak[ARENA_BOOT]);
+      UART_OutString(" setup ");
+      UART_OutUDec(Arena_PhasePeak[ARENA_SETUP]);
+      UART_OutString("\n\r");
+#endif
+      return 0;
+    case LINK_UP:
+      if(ESP8266_Connected()){
+        return 0;
+      }
+      LinkDrops++;              // lost the server, start over
+      FrameBinary = 0;          // a reset module answers in CSV until offered
+      FrameBad = 0;
+      ((vp_out_t *)VirtualPins[VP_FRAMING].context)->sent = 0;  // offer it again
+      ESP8266_Begin(ms);
+      LinkState = LINK_SETUP;
+      return 1;
+  }
+  return 0;
+}
+
+// ------------------------------ History_Upload --------------------------------
+// Called from SendInformation, so only while the link is up. Sends up to
+// HIST_BATCH history records in one ESP8266_OutString as CSV lines
+// "pin,value,age" with pin VP_HISTORY+type and age the seconds since the
+// record was taken. Two calls a second cap the catch-up after an outage
+// at 8 records a second, which keeps the account under the flood limit.
+// Binary records have no room for the age, so these are always CSV. The
+// records stay in the ring until the module is still joined after the
+// send; a batch cut off by an outage goes again, so the app may see one
+// twice, with its age, but never loses one.
+// Output: number of bytes sent
+#define VP_HISTORY  93      // VP93-VP97, one per HIST_xxx type
+#define HIST_BATCH  4
+uint32_t History_Upload(void){ history_t h[HIST_BATCH]; char *pt = TxFrame;
+  uint32_t sec, sub, bytes, n = History_Peek(h, HIST_BATCH);
+  if(n == 0) return 0;
+  Timebase_Read(&sec, &sub);
+  for(uint32_t i = 0; i < n; i++){
+    pt = FormatUDec(pt, VP_HISTORY + h[i].type);
+    *pt++ = ',';
+    pt = FormatUDec(pt, h[i].value);
+    *pt++ = ',';
+    pt = FormatUDec(pt, sec - h[i].stamp);
+    *pt++ = '.'; *pt++ = '0';
+    *pt++ = '\n';
+  }
+  *pt = 0;
+  ESP8266_OutString(TxFrame);
+  if(ESP8266_Connected()){
+    History_Commit(n);
+  }
+  bytes = pt - TxFrame;
+  TxBytesLast += bytes;
+  TxBytesTotal += bytes;
+  return bytes;
 }
 
-  
 int main(void){       
   PLL_Init(Bus80MHz);   // Bus clock at 80 MHz
+  Timebase_Init();      // 64-bit tick counter for the stopwatch and timeouts
+  Profile_Init(0);      // DWT cycle counter
   DisableInterrupts();  // Disable interrupts until finished with inits
   PortF_Init();
 	PortD_Init();
 	SysTick_Init();
-  LastF = PortF_Input();
+	ClockNext = Timebase_Now() + TIMEBASE_HZ;
+  VP_Init();
+  Digits_Init();
+  RestoreSettings();    // alarm, display mode and stopwatch from the last run
+  History_Add(HIST_BOOT, 0);
 #ifdef DEBUG3
   Output_Init();        // initialize ST7735
+  Fill_Init(0);         // fills over SSI0 with uDMA
   //ST7735_OutString("EE445L Lab 4D\nBlynk example\n");
-	drawFace();
-	drawHands(time);
-	outputTime(time, 2);
-	ST7735_DrawString(2,4,"Clock Starting...", ST7735_YELLOW);
+	if(default_phase == 0 || default_phase == 5){
+		Display_Call(&ShowClock, time, 1);
+	}
+	else Display_Call(&Digits_OutTime, time, 7);
+	if(default_phase == 0 ) {
+		Display_Call(&Digits_OutTime, time, 2);
+	}
+	Display_String(2,4,"WiFi...", ST7735_YELLOW);
+	Display_Flush();      // show it before the WiFi setup
+	FirstFrameMs = Timebase_Ms(Timebase_Now());
 #endif
+  Arena_Phase(ARENA_SETUP);
 #ifdef DEBUG1
   UART_Init(5);         // Enable Debug Serial Port
   //UART_OutString("\n\rEE445L Lab 4D\n\rBlynk example");
 #endif
-  ESP8266_Init();       // Enable ESP8266 Serial Port
-  ESP8266_Reset();      // Reset the WiFi module
-  ESP8266_SetupWiFi();  // Setup communications to Blynk Server  
-  
-  Timer2_Init(&Blynk_to_TM4C,800000); 
-  // check for receive data from Blynk App every 10ms
-
-  Timer3_Init(&SendInformation,40000000); 
-  // Send data back to Blynk App every 1/2 second
+  Alarm_Init(time);
+  setAlarm(time_alarm);
+  Event_Init();
+  PublishState();
   EnableInterrupts();
 
   while(1) {
-		long sr = StartCritical();
+		event_t e;
+		uint32_t bytes = Display_Bytes;
+		uint32_t queued = Display_Drain();  // one queued draw, then look for events again
+		LoopCount++;
+		PhaseBytes[phase_num] += Display_Bytes - bytes;
+		if(queued == 0){
+			if(VpStamp && (Display_Pending() == 0) && (PendingPresses == 0)){  // screen caught up with the last message
+				VpLatencyLast = (uint32_t)((Timebase_Now() - VpStamp)/(TIMEBASE_HZ/1000000));
+				if(VpLatencyLast > VpLatencyMax){
+					VpLatencyMax = VpLatencyLast;
+				}
+				VpStamp = 0;
+			}
+			if(Link_Step() == 0){  // ESP8266 bring-up steps, or a check that it is still up
+				Event_Wait(&secFlag);  // low power mode until SysTick, Timer2 or a fill has work
+			}
+		}
+		if(secFlag){
+			Event_Post(EVENT_SECOND, 0, 0);
+		}
+		while(Event_Get(&e)){
+			switch(e.type){
+				case EVENT_SECOND:
+					ClockTick();
+					break;
+				case EVENT_MESSAGE:
+					if(VpStamp == 0){
+						VpStamp = Timebase_Now();
+					}
+					Blynk_Receive();
+					PhaseControl(phase_num, time);  // push the widgets it dirtied
+					break;
+				case EVENT_FRAME:
+					ButtonFlush();
+					if(HeldButton) ButtonRepeat();
+					PhaseControl(phase_num, time);
+					break;
+				case EVENT_FILL:
+					break;               // Display_Drain sends the next command
+			}
+			FrameRequest = ((phase_num == 4) && sw_flag) || HeldButton;
+			ResetToFactory(isResetToFactory);
+			PublishState();
+			SoundAlarm();
+		}
+	}
+}
+
+// --------------------------------- ClockTick ---------------------------------
+// Handles EVENT_SECOND: advance the clock, check the alarm and redraw the
+// current phase. SysTick only wakes the loop; the seconds are counted on the
+// timebase, so a SysTick off the bus clock or a late pass cannot make the
+// clock drift.
+void ClockTick(void){
 		int tempTime = time;
-		time = updateTime(secFlag, time);
+		secFlag = 0;                 // cleared first, a second after the reading wakes us again
+		while(Timebase_Now() >= ClockNext){
+			time = updateTime(1, time);
+			ClockNext += TIMEBASE_HZ;
+		}
 		alarm = checkAlarm(time);
-		if(time != tempTime){ // if time changed, redraw, reset flag, check alarm
-         secFlag = 0;
-    }
-    //WaitForInterrupt(); // low power mode
+		if(alarm){
+			inAlarm = 1;
+			History_Add(HIST_ALARM, time);
+		}
+		if((time != tempTime) && ((time % 600) == 0)){
+			History_Add(HIST_SAMPLE, time);   // every 10 minutes
+		}
 		CheckInactiveTime();
 		PhaseControl(phase_num, tempTime);
-		EndCritical(sr);
-		ResetToFactory(isResetToFactory);
-	}
+		if(time != tempTime){
+			SaveSettings();
+		}
+#ifdef DEBUG1
+		if((time != tempTime) && ((time % 10) == 0)){
+			Profile_Print();      // every 10 s on the debug port
+		}
+#endif
 }
 
-void PhaseControl(uint32_t phase, uint32_t tempTime){
-			lastTimePressed = time;
+// --------------------------------- ShowClock ---------------------------------
+// Display_Call target for the analog clock: draws the face first when face is 1
+void ShowClock(int t, int face){
+		if(face){
+			Clock_DrawFace();
+		}
+		uint32_t t0 = Profile_Start();
+		Clock_DrawHands(t);
+		Profile_Stop(PROF_HANDS, t0);
+}
+
+void PhaseControl(uint32_t phase, int tempTime){
+			uint32_t t0 = Profile_Start();
+			PhaseFrames[phase]++;
+#ifdef REDRAW_ALL
+			phases[phase].dirty = DIRTY_ALL;  // as before the dirty bits, for the host bench baseline
+#endif
 	 		switch (phase) {
          case 0:
          if(time != tempTime){ // if time changed, redraw, reset flag, check alarm
-            outputTime(time, 2);	
-         }
-         if((time % 60) == 0){ // every minute, erase hand and draw again
-            eraseHands(time - 60);
-            drawHands(time);
+            Display_Call(&Digits_OutTime, time, 2);	
          }
+         Display_Call(&ShowClock, time, 0);  // only writes pixels when the hands move
          break;
 				 
          case 1:
-         ST7735_DrawString(6,4,phases[1].options[0], phases[1].color[0]);
-         ST7735_DrawString(6,6,phases[1].options[1], phases[1].color[1]);
-         ST7735_DrawString(6,8,phases[1].options[2], phases[1].color[2]);
-				 ST7735_DrawString(6,10,phases[1].options[3], phases[1].color[3]);
-         CheckInactiveTime();
-         break;
-				 
-         case 2:
-					 //ADCvalue = ADC0_InSeq3();
-					 if (phases[2].selected) {
-             if (phases[2].highlight == 2) { // hour: 1-12
-               //h = ADCvalue*12/4096 + 1; // use 4096 here to avoid 13
-							 h = temp_t/3600;
-               if (h < 10 && h > 0) {
-                  hour[0] = '0';
-                  hour[1] = 48 + h;
-               } else {
-                  hour[0] = 48 + h/10;
-                  hour[1] = 48 + h%10;
-               }
-							 if (h == 0) {
-									hour[0] = '1';
-									hour[1] = '2';
-							 }
-            }
-            else if (phases[2].highlight == 3) { // min: 0-59
-               //m = ADCvalue*60/4096; // use 4096 to avoid 60
-							 m = (temp_t % 3600) / 60;
-               if (m < 10) {
-                  min[0] = '0';
-                  min[1] = 48 + m;
-               } else {
-                  min[0] = 48 + m/10;
-                  min[1] = 48 + m%10;
-               }   
-            }
-            else if (phases[2].highlight == 4) { // sec: 0-59
-               //s = ADCvalue*60/4096;
-               s = temp_t % 60;
-               if (s < 10) {
-                  sec[0] = '0';
-                  sec[1] = 48 + s;
-               } else {
-                  sec[0] = 48 + s/10;
-                  sec[1] = 48 + s%10;
-               }   
-            }
+         for(int i = 0; i < 4; i++){
+           if(phases[1].dirty & (1 << i)){
+             Display_String(6,4+2*i,phases[1].options[i], phases[1].color[i]);
+           }
          }
-         ST7735_DrawString(8,8,phases[2].options[0], phases[2].color[0]);
-         ST7735_DrawString(8,10,phases[2].options[1], phases[2].color[1]);
-         ST7735_SetCursor(6, 6);
-         
-         ST7735_DrawString(6,6,hour,phases[2].color[2]);
-         ST7735_DrawString(8,6,":",ST7735_WHITE);
-         ST7735_DrawString(9,6,min,phases[2].color[3]);
-         ST7735_DrawString(11,6,":",ST7735_WHITE);
-         ST7735_DrawString(12,6,sec,phases[2].color[4]);
-				 CheckInactiveTime();
+         phases[1].dirty = 0;
          break;
 				 
+         case 2:
          case 3:
-					 //ADCvalue = ADC0_InSeq3();
-					 if (phases[3].selected) {
-            if (phases[3].highlight == 2) { // hour: 1-12
-               //h = ADCvalue*12/4096 + 1; // use 4096 here to avoid 13
-							 h = temp_t/3600;
-               if (h < 10 && h > 0) {
-                  hour[0] = '0';
-                  hour[1] = 48 + h;
-               } else {
-                  hour[0] = 48 + h/10;
-                  hour[1] = 48 + h%10;
-               }
-							 if (h == 0) {
-									hour[0] = '1';
-									hour[1] = '2';
-							 }							 
-            }
-            else if (phases[3].highlight == 3) { // min: 0-59
-               //m = ADCvalue*60/4096; // use 4096 to avoid 60
-							 m = (temp_t % 3600) / 60;
-               if (m < 10) {
-                  min[0] = '0';
-                  min[1] = 48 + m;
-               } else {
-                  min[0] = 48 + m/10;
-                  min[1] = 48 + m%10;
-               }   
-            }
-            else if (phases[3].highlight == 4) { // sec: 0-59
-               //s = ADCvalue*60/4096;
-               s = temp_t % 60;
-               if (s < 10) {
-                  sec[0] = '0';
-                  sec[1] = 48 + s;
-               } else {
-                  sec[0] = 48 + s/10;
-                  sec[1] = 48 + s%10;
-               }   
-            }
-         }
-           ST7735_DrawString(8,8,phases[3].options[0], phases[3].color[0]);
-           ST7735_DrawString(8,10,phases[3].options[1], phases[3].color[1]);
-           ST7735_SetCursor(6, 6);
-           ST7735_DrawString(6,6,hour,phases[3].color[2]);
-           ST7735_DrawString(8,6,":",ST7735_WHITE);
-           ST7735_DrawString(9,6,min,phases[3].color[3]);
-           ST7735_DrawString(11,6,":",ST7735_WHITE);
-           ST7735_DrawString(12,6,sec,phases[3].color[4]);
-				 CheckInactiveTime();
+         RenderSetTime(&phases[phase]);
          break;
 				 
 				 case 4:
-				 if(time != tempTime && sw_flag == 1){ // if time changed, redraw, reset flag, check alarm
-						time_sw = time - time_d;
-            outputTimer(time_sw, 6);	
+				 if(sw_flag == 1){ // running, the reading moves on every pass
+						time_sw = Timebase_Ms(Timebase_Now() - sw_start);
+						phases[4].dirty |= 1 << SW_TIMER;
            }
-				 ST7735_SetTextColor(ST7735_WHITE);
-				 outputTimer(time_sw, 6);
-				 ST7735_DrawString(8,8,phases[4].options[0], phases[4].color[0]);
-         ST7735_DrawString(8,10,phases[4].options[1], phases[4].color[1]);
-				 ST7735_DrawString(8,12,phases[4].options[2], phases[4].color[2]);
+				 if(phases[4].dirty & (1 << SW_TIMER)){
+				   Display_Call(&Digits_OutTimer, time_sw, 6);
+				 }
+				 for(int i = 0; i < 3; i++){
+				   if(phases[4].dirty & (1 << i)){
+				     Display_String(8,8+2*i,phases[4].options[i], phases[4].color[i]);
+				   }
+				 }
+				 phases[4].dirty = 0;
 				 break;
 					
 				 case 6:
-						outputTime(time, 7);
 						if(time != tempTime){ // if time changed, redraw, reset flag, check alarm
-							outputTime(time, 7);	
+							Display_Call(&Digits_OutTime, time, 7);
 						}
          break;
 				 
 				 case 5:
 					if(time != tempTime){
-						drawFace();
-						drawHands(time);
-						if((time % 60) == 0){ // every minute, erase hand and draw again
-							drawFace();
-							eraseHands(time-60);
-							drawHands(time);
-						}
+						Display_Call(&ShowClock, time, 0);  // face stays, hands move once a minute
 					}
 					break;
       }
+			Profile_Stop(PROF_PHASE, t0);
+}
+
+// ------------------------------ RenderSetTime -----------------------------------
+// Redraws the dirty widgets of the set clock (phase 2) and set alarm (phase 3)
+// screens: widgets 0-1 are Set/Back, 2-4 are the hour, minute and second fields.
+// The field being edited is reformatted from temp_t before it is drawn.
+void RenderSetTime(phase *p){
+   if (p->selected && (p->dirty & (1 << p->highlight))) {
+      if (p->highlight == 2) { // hour: 1-12
+         //h = ADCvalue*12/4096 + 1; // use 4096 here to avoid 13
+         h = temp_t/3600;
+         if (h < 10 && h > 0) {
+            hour[0] = '0';
+            hour[1] = 48 + h;
+         } else {
+            hour[0] = 48 + h/10;
+            hour[1] = 48 + h%10;
+         }
+         if (h == 0) {
+            hour[0] = '1';
+            hour[1] = '2';
+         }
+      }
+      else if (p->highlight == 3) { // min: 0-59
+         //m = ADCvalue*60/4096; // use 4096 to avoid 60
+         m = (temp_t % 3600) / 60;
+         if (m < 10) {
+            min[0] = '0';
+            min[1] = 48 + m;
+         } else {
+            min[0] = 48 + m/10;
+            min[1] = 48 + m%10;
+         }   
+      }
+      else if (p->highlight == 4) { // sec: 0-59
+         //s = ADCvalue*60/4096;
+         s = temp_t % 60;
+         if (s < 10) {
+            sec[0] = '0';
+            sec[1] = 48 + s;
+         } else {
+            sec[0] = 48 + s/10;
+            sec[1] = 48 + s%10;
+         }   
+      }
+   }
+   if(p->dirty & 0x01) Display_String(8,8,p->options[0], p->color[0]);
+   if(p->dirty & 0x02) Display_String(8,10,p->options[1], p->color[1]);
+   if(p->dirty & 0x04) Display_String(6,6,hour,p->color[2]);
+   if(p->dirty & 0x08) Display_String(9,6,min,p->color[3]);
+   if(p->dirty & 0x10) Display_String(12,6,sec,p->color[4]);
+   if(p->dirty & DIRTY_STATIC){
+      Display_String(8,6,":",ST7735_WHITE);
+      Display_String(11,6,":",ST7735_WHITE);
+   }
+   p->dirty = 0;
+}
+
+// ------------------------------ ClearScreen -------------------------------------
+// Blanks the panel and marks every widget of the current phase dirty,
+// so the next PhaseControl pass repaints that menu exactly once.
+void ClearScreen(void){
+   Display_FillRect(0, 0, ST7735_TFTWIDTH, ST7735_TFTHEIGHT, ST7735_BLACK);   // clear the screen
+   phases[phase_num].dirty = DIRTY_ALL;
+}
+
+// ------------------------------ MoveHighlight -----------------------------------
+// Moves the yellow highlight of a menu to widget next; only the widget losing
+// the highlight and the one gaining it are redrawn.
+void MoveHighlight(phase *p, int8_t next){
+   p->color[p->highlight] = ST7735_WHITE;
+   p->dirty |= 1 << p->highlight;
+   p->highlight = next;
+   p->color[p->highlight] = ST7735_YELLOW;
+   p->dirty |= 1 << p->highlight;
+}
+
+// ------------------------------ AdjustField -----------------------------------
+// Step the selected hour, minute or second of the set clock/alarm screen by
+// dir (+1 up, -1 down) for presses presses at once. Presses of the same
+// button less than REPEAT_GAP apart, and repeats while it is held, form a
+// streak: the first 4 steps move 1 unit, the next 5 move 5 units and after
+// that 15 units. The presses of a burst are added up into one change of
+// temp_t and the field is marked dirty once, so it is redrawn once.
+#define REPEAT_GAP    (TIMEBASE_HZ/2)   // presses closer than this are a streak
+#define REPEAT_DELAY  (TIMEBASE_HZ/2)   // held this long before repeating
+#define REPEAT_RATE   (TIMEBASE_HZ/5)   // then one step per 200 ms
+uint64_t HeldNext;           // tick of the next auto-repeat
+uint32_t Streak, StreakButton;
+uint64_t StreakLast;         // tick of the last step in the streak
+uint32_t Button_Presses;     // VP2/VP3 presses that changed a field
+uint32_t Button_Repeats;     // steps added by holding a button
+void AdjustField(phase *p, uint32_t num, int dir, uint32_t presses){
+   static const int Unit[5] = {0, 0, 3600, 60, 1};
+   uint64_t now = Timebase_Now();
+   int step = 0;
+   if((num != StreakButton) || (now - StreakLast > REPEAT_GAP)){
+      Streak = 0;
+   }
+   StreakButton = num;
+   StreakLast = now;
+   while(presses--){
+      step += (Streak < 4) ? 1 : (Streak < 9) ? 5 : 15;
+      Streak++;
+   }
+   temp_t = (temp_t + dir*step*Unit[p->highlight]) % 43200;
+   if (temp_t < 0) temp_t += 43200;
+   p->dirty |= 1 << p->highlight;
+}
+
+// ------------------------------ ButtonRepeat ----------------------------------
+// Called on EVENT_FRAME while a field button is held: repeats its step
+void ButtonRepeat(void){
+   uint64_t now = Timebase_Now();
+   phase *p = &phases[phase_num];
+   if(((phase_num != 2) && (phase_num != 3)) || !p->selected){
+      HeldButton = 0;          // left the field, stop repeating
+      return;
+   }
+   if(HeldButton && (now >= HeldNext)){
+      HeldNext = now + REPEAT_RATE;
+      AdjustField(p, HeldButton, (HeldButton == 3) ? 1 : -1, 1);
+      Button_Repeats++;
+   }
+}
+
+// ------------------------------ ButtonFlush -----------------------------------
+// Applies the field presses counted by Press as one step. Called on
+// EVENT_FRAME, which Timer2 posts once a poll finds the burst has ended,
+// and before any other button is handled.
+uint32_t PendingButton;      // VP2 or VP3 of the pending presses
+int PendingDir;
+phase *PendingPhase;
+void ButtonFlush(void){
+   if(PendingPresses){
+      AdjustField(PendingPhase, PendingButton, PendingDir, PendingPresses);
+      PendingPresses = 0;
+   }
+}
+
+// A press on a selected field: counted now and stepped once the burst it is
+// in has been drained, auto-repeat if it stays down
+void Press(phase *p, uint32_t num, int dir){
+   if(PendingPresses && ((num != PendingButton) || (p != PendingPhase))){
+      ButtonFlush();
+   }
+   PendingButton = num;
+   PendingDir = dir;
+   PendingPhase = p;
+   PendingPresses++;
+   HeldButton = num;
+   HeldNext = Timebase_Now() + REPEAT_DELAY;
+   Button_Presses++;
 }
 
 void ButtonControl(uint32_t value, uint32_t num){
+   lastTimePressed = Timebase_Now();
+   if(PendingPresses && (value == 1) && (num != PendingButton)){
+      ButtonFlush();           // another button, finish the burst first
+   }
+   if((value == 0) && (num == HeldButton)){
+      HeldButton = 0;          // released
+   }
 // ********************************When PF0/SW2 is pressed******************************** // GPIO_PORTF_RIS_R&0x01
 // ********************************When PF0/SW2 is pressed******************************** // GPIO_PORTF_RIS_R&0x01
 
@@ -426,7 +987,7 @@ void ButtonControl(uint32_t value, uint32_t num){
          switch (phase_num) {
             case 0:  //enter phase 1
 							phase_num  = 1;
-							ST7735_FillScreen(ST7735_BLACK);   // clear the screen
+							ClearScreen();   // clear the screen
             break;
             
             case 1:
@@ -437,7 +998,7 @@ void ButtonControl(uint32_t value, uint32_t num){
                getSeconds(time, sec);  // with exactly 2 digits
                getMinutes(time, min);  // with exactly 2 digits
                getHours(time, hour);  // with exactly 2 digits  
-               ST7735_FillScreen(ST7735_BLACK);   // clear the screen							
+               ClearScreen();   // clear the screen							
             }
             else if (phases[1].highlight == 1) {
                phase_num = 3;
@@ -445,25 +1006,24 @@ void ButtonControl(uint32_t value, uint32_t num){
                getSeconds(time_alarm, sec);  // with exactly 2 digits
                getMinutes(time_alarm, min);  // with exactly 2 digits
                getHours(time_alarm, hour);  // with exactly 2 digits
-               ST7735_FillScreen(ST7735_BLACK);   // clear the screen							
+               ClearScreen();   // clear the screen							
             }
             else if (phases[1].highlight == 2) {
                phase_num = default_phase;
-               ST7735_FillScreen(ST7735_BLACK);   // clear the screen
+               ClearScreen();   // clear the screen
 							 if(default_phase == 0 || default_phase == 5){
-									drawFace();
-								  drawHands(time);
+									Display_Call(&ShowClock, time, 1);
 							 }
-							 else outputTime(time, 7);
+							 else Display_Call(&Digits_OutTime, time, 7);
                if(default_phase == 0 ) {
-									outputTime(time, 2);
+									Display_Call(&Digits_OutTime, time, 2);
 							 }
             }
 						/* stop watch */
 						else if (phases[1].highlight == 3) {
                phase_num = 4;
-               ST7735_FillScreen(ST7735_BLACK);   // clear the screen
-							 outputTime(time, 2);
+               ClearScreen();   // clear the screen
+							 Display_Call(&Digits_OutTime, time, 2);
             }
             break;
             
@@ -472,20 +1032,22 @@ void ButtonControl(uint32_t value, uint32_t num){
                if (phases[2].selected == 1) {
                   phases[2].selected = 0;
                   phases[2].color[phases[2].highlight] = ST7735_YELLOW;
+                  phases[2].dirty |= 1 << phases[2].highlight;
                }
                else if (phases[2].selected == 0) {
                   phases[2].selected = 1;
                   phases[2].color[phases[2].highlight] = ST7735_BLUE;
+                  phases[2].dirty |= 1 << phases[2].highlight;
                }
             }
             else if (phases[2].highlight == 0) {  // save
                phase_num = 1;
                time = (h%12) * 3600 + m * 60 + s;
-               ST7735_FillScreen(ST7735_BLACK);
+               ClearScreen();
             }
             else if (phases[2].highlight == 1) {
                phase_num = 1;
-               ST7735_FillScreen(ST7735_BLACK);
+               ClearScreen();
             }
             break;
 						
@@ -494,66 +1056,71 @@ void ButtonControl(uint32_t value, uint32_t num){
                if (phases[3].selected == 1) {
                   phases[3].selected = 0;
                   phases[3].color[phases[3].highlight] = ST7735_YELLOW;
+                  phases[3].dirty |= 1 << phases[3].highlight;
                }
                else if (phases[3].selected == 0) {
                   phases[3].selected = 1;
                   phases[3].color[phases[3].highlight] = ST7735_BLUE;
+                  phases[3].dirty |= 1 << phases[3].highlight;
                }
             }
             else if (phases[3].highlight == 0) {  // save
                phase_num = 1;
-               time_alarm = (h%12) * 3600 + m * 60 + s;
-               ST7735_FillScreen(ST7735_BLACK);
+               setAlarm((h%12) * 3600 + m * 60 + s);
+               ClearScreen();
             }
             else if (phases[3].highlight == 1) {
                phase_num = 1;
-               ST7735_FillScreen(ST7735_BLACK);
+               ClearScreen();
                
             }
             break;
 						
 						case 4:
             if (phases[4].highlight == 0){
-							if(d_flag == 0){
-								time_d = time;
-								d_flag ++;
+							if(sw_flag == 0){
+								sw_start = Timebase_Now() - sw_stopped;   // start the timer
+								sw_flag = 1;
+							}
+							else{
+								sw_stopped = Timebase_Now() - sw_start;   // stop it
+								sw_flag = 0;
+								time_sw = Timebase_Ms(sw_stopped);
+								History_Add(HIST_LAP, time_sw);
 							}
-							sw_flag = (sw_flag+1)%2;
-							if(sw_flag == 1)
-								time_sw = time - time_d;
-                  // start the timer				
+							phases[4].dirty |= 1 << SW_TIMER;
             }
             else if (phases[4].highlight == 1) {
-							sw_flag = 0;
+							if(sw_flag == 1){
+								sw_stopped = Timebase_Now() - sw_start;
+								sw_flag = 0;
+							}
 							phases[4].options[1] = "Reset";
-							//time_sw = time_sw;
 							reset_flag ++;
-							if(reset_flag){
-								time_sw = time - time_d;
-							}
+							time_sw = Timebase_Ms(sw_stopped);
 							if(reset_flag == 2){
 								time_sw = 0;
-								time_d = time;
-								d_flag = 0;
+								sw_stopped = 0;
 								reset_flag = 0;
 								phases[4].options[1] = "Pause";
 							}
+							phases[4].dirty |= (1 << 1) | (1 << SW_TIMER);
                  // pause or reset the timer					
             }
             else if (phases[4].highlight == 2) {
                phase_num = 1;
-               ST7735_FillScreen(ST7735_BLACK);   // clear the screen
+               ClearScreen();   // clear the screen
             }
 						break;
 						
 						case 5:  //enter phase 6
 							 phase_num  = 1;
-							 ST7735_FillScreen(ST7735_BLACK);   // clear the screen
+							 ClearScreen();   // clear the screen
             break;
 						
 						case 6:  //enter phase 0
 							 phase_num  = 1;
-							 ST7735_FillScreen(ST7735_BLACK);   // clear the screen
+							 ClearScreen();   // clear the screen
             break;
          }
       }
@@ -563,175 +1130,116 @@ void ButtonControl(uint32_t value, uint32_t num){
 // ********************************When V2 is pressed******************************** 
    if (value == 1 && num == 2) {  // down
       //GPIO_PORTF_IM_R &= ~0x01;     // disarm interrupt on PF0
-      long sr;
+      long sr; uint32_t masked;
 			if(1){    // 0x01 means it was previously released; negative logic
          switch (phase_num) {
             default: 			
 							if(inAlarm == 1)
 								phase_num = default_phase;
 							sr = StartCritical();
+							masked = Profile_Start();
 							inAlarm = 0;
+							Profile_Stop(PROF_MASKED, masked);
 							EndCritical(sr);
             // alarm
             break;
             
             case 1:
-            phases[1].color[phases[1].highlight] = ST7735_WHITE;
-            phases[1].highlight = (phases[1].highlight+1)%4;
-            phases[1].color[phases[1].highlight] = ST7735_YELLOW;
+            MoveHighlight(&phases[1], (phases[1].highlight+1)%4);
             break;
             
             case 2:
 							if (phases[2].selected) {
-								if (phases[2].highlight == 2) { // hour: 1-12
-									temp_t -= 3600;
-								}
-								else if (phases[2].highlight == 3) { // min: 0-59
-									temp_t -= 60;
-								}
-								else if (phases[2].highlight == 4) { // sec: 0-59
-									 temp_t --;  
-								}
-								if (temp_t < 0) temp_t += 43200;
+								Press(&phases[2], num, -1);
 								break;
 						 }
-            phases[2].color[phases[2].highlight] = ST7735_WHITE;
-            phases[2].highlight = (phases[2].highlight+1)%5;
-            phases[2].color[phases[2].highlight] = ST7735_YELLOW;
+            MoveHighlight(&phases[2], (phases[2].highlight+1)%5);
             break;
             
             case 3:
             if (phases[3].selected){
-								if (phases[3].highlight == 2) { // hour: 1-12
-									temp_t -= 3600;
-								}
-								else if (phases[3].highlight == 3) { // min: 0-59
-									temp_t -= 60;
-								}
-								else if (phases[3].highlight == 4) { // sec: 0-59
-									 temp_t --;  
-								}
-								if (temp_t < 0) temp_t += 43200;
+							Press(&phases[3], num, -1);
 							break; 
 						}
-            phases[3].color[phases[3].highlight] = ST7735_WHITE;
-            phases[3].highlight = (phases[3].highlight+1)%5;
-            phases[3].color[phases[3].highlight] = ST7735_YELLOW;
+            MoveHighlight(&phases[3], (phases[3].highlight+1)%5);
             break;
 						
 						case 4:
-						phases[4].color[phases[4].highlight] = ST7735_WHITE;
-            phases[4].highlight = (phases[4].highlight+1)%3;
-            phases[4].color[phases[4].highlight] = ST7735_YELLOW;
+						MoveHighlight(&phases[4], (phases[4].highlight+1)%3);
 						
          }
       }
    }
 // ********************************When V3 is pressed********************************
 	 if (value == 1 && num == 3) {	// up
-		  long sr;
+		  long sr; uint32_t masked;
 			if(1){    // 0x01 means it was previously released; negative logic
          switch (phase_num) {
             default: 			
 							if(inAlarm == 1)
 								phase_num = default_phase;
 							sr = StartCritical();
+							masked = Profile_Start();
 							inAlarm = 0;
+							Profile_Stop(PROF_MASKED, masked);
 							EndCritical(sr);
             // alarm
             break;
             
             case 1:
-            phases[1].color[phases[1].highlight] = ST7735_WHITE;
-            phases[1].highlight = (phases[1].highlight+3)%4;
-            phases[1].color[phases[1].highlight] = ST7735_YELLOW;
+            MoveHighlight(&phases[1], (phases[1].highlight+3)%4);
             break;
             
             case 2:
             if (phases[2].selected){
-								if (phases[2].highlight == 2) { // hour: 1-12
-									temp_t += 3600;
-									if (temp_t > 43200) temp_t -= 43200;
-								}
-								else if (phases[2].highlight == 3) { // min: 0-59
-									temp_t += 60;
-									if (temp_t > 43200) temp_t -= 3600;
-								}
-								else if (phases[2].highlight == 4) { // sec: 0-59
-									temp_t ++;  
-									if (temp_t > 43200) temp_t -= 60;
-								}
+								Press(&phases[2], num, 1);
 								break;
 						}
-            phases[2].color[phases[2].highlight] = ST7735_WHITE;
-            phases[2].highlight = (phases[2].highlight+4)%5;
-            phases[2].color[phases[2].highlight] = ST7735_YELLOW;
+            MoveHighlight(&phases[2], (phases[2].highlight+4)%5);
             break;
             
             case 3:
             if (phases[3].selected){
-								if (phases[3].highlight == 2) { // hour: 1-12
-									temp_t += 3600;
-									if (temp_t > 43200) temp_t -= 43200;
-								}
-								else if (phases[3].highlight == 3) { // min: 0-59
-									temp_t += 60;
-									if (temp_t > 43200) temp_t -= 3600;
-								}
-								else if (phases[3].highlight == 4) { // sec: 0-59
-									temp_t ++;  
-									if (temp_t > 43200) temp_t -= 60;
-								}
+							Press(&phases[3], num, 1);
 							break; 
 						}
-            phases[3].color[phases[3].highlight] = ST7735_WHITE;
-            phases[3].highlight = (phases[3].highlight+4)%5;
-            phases[3].color[phases[3].highlight] = ST7735_YELLOW;
+            MoveHighlight(&phases[3], (phases[3].highlight+4)%5);
             break;
 						
 						case 4:
-						phases[4].color[phases[4].highlight] = ST7735_WHITE;
-            phases[4].highlight = (phases[4].highlight+2)%3;
-            phases[4].color[phases[4].highlight] = ST7735_YELLOW;
+						MoveHighlight(&phases[4], (phases[4].highlight+2)%3);
 						
          }
       }
 	 }
 // ********************************When V4 is pressed********************************
    if (value == 1 && num == 4) {	// mode/silence alarm
-		 long sr = StartCritical();
 		 if(inAlarm == 0){
 				switch (phase_num) {
 					  default:
-								ST7735_FillScreen(ST7735_BLACK);
-								EndCritical(sr);						
+								ClearScreen();
 								break;
 					
 						case 0:  //enter phase 5
 								phase_num = 5;
 								default_phase = 5;
-								ST7735_FillScreen(ST7735_BLACK); 
-								drawFace();
-								drawHands(time);
-								EndCritical(sr);
+								ClearScreen(); 
+								Display_Call(&ShowClock, time, 1);
             break;
 						
 						case 5:  //enter phase 6
 							 phase_num  = 6;
 							 default_phase = 6;
-							 outputTime(time, 7);
-							 ST7735_FillScreen(ST7735_BLACK);   // clear the screen
-							 EndCritical(sr);
+							 Display_Call(&Digits_OutTime, time, 7);
+							 ClearScreen();   // clear the screen
             break;
 						
 						case 6:  //enter phase 0
                phase_num = 0;
 							 default_phase = 0;
-               ST7735_FillScreen(ST7735_BLACK);   // clear the screen
-							 outputTime(time, 2);
-               drawFace();
-               drawHands(time);
-							 EndCritical(sr);
+               ClearScreen();   // clear the screen
+							 Display_Call(&Digits_OutTime, time, 2);
+               Display_Call(&ShowClock, time, 1);
             break;
 				}	
 		}
@@ -746,18 +1254,20 @@ void ButtonControl(uint32_t value, uint32_t num){
 }
 
 
+// Falls back to the default clock display after 25 s without a Blynk button
+// in a menu; a running stopwatch keeps its screen
 void CheckInactiveTime(void){
-		timeInactive = time - lastTimePressed;
-		if(timeInactive >= 25){
+		uint64_t timeInactive = Timebase_Now() - lastTimePressed;
+		if((timeInactive >= 25ULL*TIMEBASE_HZ) && (phase_num != default_phase) &&
+		   !((phase_num == 4) && sw_flag)){
 						 phase_num = default_phase; 
-						 ST7735_FillScreen(ST7735_BLACK);   // clear the screen
+						 ClearScreen();   // clear the screen
 						 if(default_phase == 0 || default_phase == 5){
-								drawFace();
-								drawHands(time);
+								Display_Call(&ShowClock, time, 1);
 						 }
-						 else outputTime(time, 7);
+						 else Display_Call(&Digits_OutTime, time, 7);
              if(default_phase == 0 ) {
-								outputTime(time, 2);
+								Display_Call(&Digits_OutTime, time, 2);
 						 }
 		}
 }
@@ -765,9 +1275,13 @@ void CheckInactiveTime(void){
 
 void ResetToFactory(int isFactory){
 		if(isFactory){
+			History_Add(HIST_RESET, 0);
 			time = Factory_Time;
-			time_alarm = Factory_Alarm;
+			setAlarm(Factory_Alarm);
 			time_sw = 0;
+			sw_flag = 0;
+			sw_stopped = 0;
+			reset_flag = 0;
 			isResetToFactory = 0;
 			alarm = 0;
 			inAlarm = 0;
@@ -775,10 +1289,39 @@ void ResetToFactory(int isFactory){
 			phase_num = 0;
 		}
 }
+// ------------------------------ Settings ---------------------------------------
+// The alarm, display mode and paused stopwatch survive resets in the EEPROM
+// settings log. SaveSettings runs once a second; edits only reach the
+// EEPROM after they have been quiet for SETTINGS_QUIET seconds.
+int SettingsOk;                 // 1 if the EEPROM came up
+uint32_t SettingsRestoreUs;     // time RestoreSettings spent reading the log
+void RestoreSettings(void){ settings_t saved;
+  uint64_t start = Timebase_Now();
+  SettingsOk = (Eeprom_Init() == 0);
+  if(SettingsOk && Settings_Init(&Eeprom_Storage, &saved)){
+    time_alarm = saved.alarm % ALARM_DAY;
+    if((saved.phase == 0) || (saved.phase == 5) || (saved.phase == 6)){
+      default_phase = phase_num = saved.phase;
+    }
+    time_sw = saved.stopwatch;
+    sw_stopped = (uint64_t)saved.stopwatch*(TIMEBASE_HZ/1000);
+  }
+  SettingsRestoreUs = (uint32_t)((Timebase_Now() - start)/(TIMEBASE_HZ/1000000));
+}
+
+void SaveSettings(void){ settings_t now;
+  if(!SettingsOk) return;
+  now.alarm = time_alarm;
+  now.phase = default_phase;
+  now.stopwatch = sw_flag ? 0 : time_sw;  // a running stopwatch is not kept
+  Settings_Save(&now);
+  Settings_Poll();
+}
+
 /* initialize PortD */
 void PortD_Init(void){
    SYSCTL_RCGCGPIO_R |= SYSCTL_RCGC2_GPIOD;        // 1) activate port D
-   uint8_t delay = SYSCTL_RCGC2_R; ;   // allow time for clock to stabilize
+   while((SYSCTL_PRGPIO_R&SYSCTL_PRGPIO_R3) == 0){};   // wait for the clock to stabilize
    // 2) no need to unlock PD3-0
    GPIO_PORTD_AMSEL_R &= ~0x0F;      // 3) disable analog functionality on PD3-0
    GPIO_PORTD_PCTL_R &= ~0x0000FFFF; // 4) GPIO
@@ -0,0 +1,246 @@
+// -------------------------------------------------------------------
+// File name: Clock.c
+// Description: Analog clock face for phases 0 and 5. The face image is
+//              drawn once after the screen is cleared; after that only the
+//              pixels where the hands moved are written to the ST7735, and
+//              pixels a hand leaves are restored from the face image.
+//              The hand end points come from a quarter-wave sine table in
+//              fixed point, with the same pixels the floating-point
+//              sin/cos of the original drawHands gave.
+//------------------------------------------------------------------------------
+#include <stdint.h>
+#include "ST7735.h"
+#include "Tiles.h"
+#include "Arena.h"
+#include "Clock.h"
+
+#define FACE_X    23            // lower left corner of the face image
+#define FACE_Y    140
+#define FACE_SIZE 80            // pixels on a side
+#define CX        61            // pivot of the hands
+#define CY        100
+#define HOUR_COLOR    ST7735_BLUE
+#define MINUTE_COLOR  ST7735_WHITE
+#define HANDMAX   96            // four lines of at most 21 pixels
+
+#define MINUTE_LEN  20          // hand lengths in pixels
+#define HOUR_LEN    15
+#define BAND        4           // face rows expanded per ST7735_DrawBitmap
+
+extern const uint8_t ClockFace[FACE_SIZE*FACE_SIZE/4];  // ClockFace.c, 2 bits a pixel
+extern const uint16_t ClockPalette[4];
+
+// sin(k/2 degrees) in 1/32768 units for k = 0 to 180, a quarter wave
+static const uint16_t Sine[181] = {
+      0,   286,   572,   858,  1144,  1429,  1715,  2000,  2286,  2571,
+   2856,  3141,  3425,  3709,  3993,  4277,  4560,  4843,  5126,  5408,
+   5690,  5971,  6252,  6533,  6813,  7092,  7371,  7650,  7927,  8204,
+   8481,  8757,  9032,  9307,  9580,  9854, 10126, 10397, 10668, 10938,
+  11207, 11476, 11743, 12010, 12275, 12540, 12803, 13066, 13328, 13589,
+  13848, 14107, 14365, 14621, 14876, 15131, 15384, 15636, 15886, 16136,
+  16384, 16631, 16877, 17121, 17364, 17606, 17847, 18086, 18324, 18560,
+  18795, 19028, 19261, 19491, 19720, 19948, 20174, 20399, 20622, 20843,
+  21063, 21281, 21498, 21713, 21926, 22138, 22348, 22556, 22763, 22967,
+  23170, 23372, 23571, 23769, 23965, 24159, 24351, 24542, 24730, 24917,
+  25102, 25285, 25466, 25645, 25822, 25997, 26170, 26341, 26510, 26677,
+  26842, 27005, 27166, 27325, 27482, 27636, 27789, 27939, 28088, 28234,
+  28378, 28520, 28660, 28797, 28932, 29066, 29197, 29325, 29452, 29576,
+  29698, 29818, 29935, 30050, 30163, 30274, 30382, 30488, 30592, 30693,
+  30792, 30888, 30983, 31075, 31164, 31251, 31336, 31419, 31499, 31576,
+  31651, 31724, 31795, 31863, 31928, 31991, 32052, 32110, 32166, 32219,
+  32270, 32319, 32365, 32408, 32449, 32488, 32524, 32557, 32588, 32617,
+  32643, 32667, 32688, 32707, 32723, 32737, 32748, 32757, 32763, 32767,
+  32768
+};
+
+// sin(h/2 degrees) in 1/32768 units, any h; the other three quarters
+// and the cosine are reflections of the table
+static int32_t SineQ15(int h){
+  int q, r;
+  h %= 720;
+  if(h < 0) h += 720;
+  q = h/180;
+  r = h%180;
+  if(q & 1) r = 180 - r;
+  return (q < 2) ? Sine[r] : -Sine[r];
+}
+
+static int Sign(int32_t v){
+  return (v > 0) - (v < 0);
+}
+
+// len*v/32768 truncated toward zero. The original used PI = 3.14159,
+// which turns every angle a hair toward 3 o'clock; where the product is
+// a whole number that makes it land just short, unless the turn makes
+// this component grow.
+static int Component(int len, int32_t v, int grow){
+  int32_t p = len*((v < 0) ? -v : v);
+  int n = p >> 15;
+  if(((p & 0x7FFF) == 0) && (n != 0) && !grow){
+    n--;
+  }
+  return (v < 0) ? -n : n;
+}
+
+// Screen position of the end of a hand len pixels long at h half degrees
+// counterclockwise from 3 o'clock, truncated toward the pivot
+static void Endpoint(int len, int h, int *x, int *y){
+  int32_t s = SineQ15(h), c = SineQ15(h + 180);
+  int turn = Sign(c)*Sign(s)*Sign(h);   // > 0 if turning toward 0 grows x
+  *x = CX + Component(len, c, (h == 0) || (turn > 0));
+  *y = CY - Component(len, s, (h == 0) || (turn < 0));
+}
+
+typedef struct hand_t {
+  uint8_t x[HANDMAX];
+  uint8_t y[HANDMAX];
+  uint8_t n;                    // pixels in use, 0 if not on screen
+} hand_t;
+static hand_t Hands[2];         // [0] hour, [1] minute, as last drawn
+static int LastPosition = -1;   // minute of the 12 hour dial last drawn
+uint32_t Clock_PixelsWritten;
+
+static void PutPixel(int16_t x, int16_t y, uint16_t color){
+  ST7735_DrawPixel(x, y, color);
+  Clock_PixelsWritten++;
+}
+
+// Color of pixel i of the face image
+static uint16_t FacePixel(int i){
+  return ClockPalette[(ClockFace[i >> 2] >> (2*(i & 3))) & 3];
+}
+
+// Color of the face image under screen pixel (x,y), black outside it.
+// Row 0 of the image is its bottom row.
+static uint16_t FaceColor(int x, int y){
+  int col = x - FACE_X, row = FACE_Y - y;
+  if((col < 0)||(col >= FACE_SIZE)||(row < 0)||(row >= FACE_SIZE)){
+    return ST7735_BLACK;
+  }
+  return FacePixel(row*FACE_SIZE + col);
+}
+
+static int OnHand(const hand_t *h, uint8_t x, uint8_t y){
+  for(int i = 0; i < h->n; i++){
+    if((h->x[i] == x) && (h->y[i] == y)) return 1;
+  }
+  return 0;
+}
+
+static void AddPixel(hand_t *h, int x, int y){
+  if((h->n < HANDMAX) && !OnHand(h, x, y)){
+    h->x[h->n] = x;
+    h->y[h->n] = y;
+    h->n++;
+  }
+}
+
+// The pixels ST7735_Line(x1,y1,x2,y2) writes, in the same arithmetic. A
+// vertical line is one DrawFastVLine that stops a pixel short of the lower
+// end; any other line steps along its longer axis and truncates the other.
+static void LinePixels(hand_t *h, int x1, int y1, int x2, int y2){
+  int dx = (x2 > x1) ? x2-x1 : x1-x2;
+  int dy = (y2 > y1) ? y2-y1 : y1-y2;
+  if(x1 == x2){
+    for(int y = (y2 > y1) ? y1 : y2, n = dy; n > 0; n--, y++){
+      AddPixel(h, x1, y);
+    }
+  } else if(dx >= dy){
+    for(int x = (x1 < x2) ? x1 : x2; x <= ((x1 < x2) ? x2 : x1); x++){
+      AddPixel(h, x, y1 + (y2-y1)*(x-x1)/(x2-x1));
+    }
+  } else{
+    for(int y = (y1 < y2) ? y1 : y2; y <= ((y1 < y2) ? y2 : y1); y++){
+      AddPixel(h, x1 + (x2-x1)*(y-y1)/(y2-y1), y);
+    }
+  }
+}
+
+// The pixels ST7735_4Line writes for a hand from the pivot to (x,y): the
+// line four times, shifted right and down by one, so it is two pixels thick
+static void HandPixels(hand_t *h, int x, int y){
+  h->n = 0;
+  LinePixels(h, CX, CY, x, y);
+  LinePixels(h, CX, CY+1, x, y+1);
+  LinePixels(h, CX+1, CY, x+1, y);
+  LinePixels(h, CX+1, CY+1, x+1, y+1);
+}
+
+// Color of (x,y) with the given hands on top of the face. The minute hand
+// is drawn after the hour hand, so it wins where they cross.
+static uint16_t ColorAt(const hand_t *hands, uint8_t x, uint8_t y){
+  if(OnHand(&hands[1], x, y)) return MINUTE_COLOR;
+  if(OnHand(&hands[0], x, y)) return HOUR_COLOR;
+  return FaceColor(x, y);
+}
+
+// Writes pixel i of list k if its color differs between the old and new hands.
+// A pixel that also sits in an earlier list was already handled.
+static void UpdatePixel(const hand_t *lists[], int k, int i,
+                        const hand_t *old, const hand_t *new){
+  uint8_t x = lists[k]->x[i], y = lists[k]->y[i];
+  uint16_t color;
+  for(int j = 0; j < k; j++){
+    if(OnHand(lists[j], x, y)) return;
+  }
+  color = ColorAt(new, x, y);
+  if(ColorAt(old, x, y) != color){
+    PutPixel(x, y, color);
+  }
+}
+
+//------------Clock_DrawFace------------
+// Draw the face image, numerals 1 to 12 on a gray dial, without hands.
+// The hands are considered erased and are drawn in full by the next
+// Clock_DrawHands. The image is expanded to RGB565 BAND rows at a time in
+// the arena, or a row at a time on the stack if it has no room.
+// Input: none
+// Output: none
+void Clock_DrawFace(void){
+  uint16_t line[FACE_SIZE];
+  uint32_t mark = Arena_Mark();     // the band takes turns with the line bitmap
+  uint16_t *band = Arena_Alloc(BAND*FACE_SIZE*sizeof(uint16_t));
+  int rows = BAND;
+  if(band == 0){
+    band = line;
+    rows = 1;
+  }
+  for(int row = 0; row < FACE_SIZE; row += rows){
+    for(int i = 0; i < rows*FACE_SIZE; i++){
+      band[i] = FacePixel(row*FACE_SIZE + i);
+    }
+    ST7735_DrawBitmap(FACE_X, FACE_Y - row, band, FACE_SIZE, rows);
+  }
+  Arena_Release(mark);
+  Clock_PixelsWritten += FACE_SIZE*FACE_SIZE;
+  Hands[0].n = Hands[1].n = 0;
+  LastPosition = -1;
+}
+
+//------------Clock_DrawHands------------
+// Move the hands to show time t. Only pixels that change color are written:
+// pixels the hands leave are restored from the face image, pixels they now
+// cover are drawn. Returns right away if the hands have not moved.
+// Input: t seconds since midnight
+// Output: none
+void Clock_DrawHands(int t){
+  hand_t new[2];
+  int position = (t/60)%720;    // minute of the 12 hour dial
+  int x, y;
+  if(position == LastPosition) return;
+  Endpoint(HOUR_LEN, 180 - position, &x, &y);      // half a degree a minute
+  HandPixels(&new[0], x, y);
+  Endpoint(MINUTE_LEN, 180 - 12*((t/60)%60), &x, &y);
+  HandPixels(&new[1], x, y);
+  {
+    const hand_t *lists[4] = {&Hands[0], &Hands[1], &new[0], &new[1]};
+    for(int k = 0; k < 4; k++){
+      for(int i = 0; i < lists[k]->n; i++){
+        UpdatePixel(lists, k, i, Hands, new);
+      }
+    }
+  }
+  Hands[0] = new[0];
+  Hands[1] = new[1];
+  LastPosition = position;
+}
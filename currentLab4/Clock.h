@@ -0,0 +1,20 @@
+// -------------------------------------------------------------------
+// File name: Clock.h
+// Description: Analog clock face for phases 0 and 5, redrawn incrementally
+//------------------------------------------------------------------------------
+#include <stdint.h>
+
+// pixels sent to the ST7735 by the clock since reset
+extern uint32_t Clock_PixelsWritten;
+
+//------------Clock_DrawFace------------
+// Draw the face image, numerals 1 to 12 on a gray dial, without hands
+// Input: none
+// Output: none
+void Clock_DrawFace(void);
+
+//------------Clock_DrawHands------------
+// Move the hands to show time t, writing only the pixels that change
+// Input: t seconds since midnight
+// Output: none
+void Clock_DrawHands(int t);
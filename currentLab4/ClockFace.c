@@ -0,0 +1,115 @@
+// -------------------------------------------------------------------
+// File name: ClockFace.c
+// Description: 80 by 80 image of the analog clock face, numerals 1 to 12
+//              on a gray dial, bottom row first as ST7735_DrawBitmap
+//              expects. Same pixels as clockFace in the lab's LCD.c, which
+//              only uses three colors, so each pixel is a 2-bit index into
+//              ClockPalette, four to a byte with pixel i in bits 2*(i%4)
+//              of byte i/4.
+//------------------------------------------------------------------------------
+#include <stdint.h>
+
+const uint16_t ClockPalette[4] = {0x0000, 0xC618, 0xFFFF, 0x0000};
+
+const uint8_t ClockFace[80*80/4] = {
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xA8, 0x02, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x02, 0x0A, 0x00, 0x00, 0x80, 0x2A, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x28, 0x00, 0x00, 0x00, 0x80, 0x02, 0x0A, 0x00, 0x00, 0x80, 0x82, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x20, 0x00, 0x00, 0x00, 0x80, 0x02, 0x0A, 0x00, 0x00, 0x00, 0x80, 0x02,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x20, 0x00, 0x00, 0x00, 0x80, 0x02, 0x0A, 0x00,
+  0x00, 0x00, 0x80, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x20, 0x00, 0x00, 0x00,
+  0x80, 0xA2, 0x02, 0x00, 0x00, 0x00, 0xAA, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x80, 0x00, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0xAA, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x80, 0x00, 0x00, 0x00, 0x00, 0x0A, 0x00, 0x00, 0x00, 0x00, 0x02, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x00, 0x00, 0x00, 0x00, 0x28, 0x00, 0x00,
+  0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x00, 0x02, 0x00, 0x00,
+  0x00, 0x80, 0x0A, 0x00, 0x00, 0x00, 0xAA, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80,
+  0xAA, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xAA, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x80, 0xAA, 0x42, 0x01, 0x00, 0x00, 0x50, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, 0x05, 0x00, 0x55, 0x55, 0x55, 0x05,
+  0x00, 0x50, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x15, 0x55,
+  0x55, 0x55, 0x55, 0x55, 0x05, 0x14, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x54, 0x55, 0x01, 0x50, 0x00, 0x54, 0x55, 0x14, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x54, 0x01, 0x00, 0x50, 0x00, 0x00, 0x54, 0x05, 0x00, 0x00,
+  0x00, 0x80, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x55, 0x00, 0x00, 0x50, 0x00, 0x00,
+  0x50, 0x05, 0x00, 0x00, 0x00, 0x80, 0x02, 0x00, 0x00, 0xA8, 0x02, 0x00, 0x00, 0x50, 0x45, 0x01,
+  0x00, 0x50, 0x00, 0x00, 0x40, 0x55, 0x00, 0x00, 0x00, 0x80, 0x02, 0x00, 0x00, 0x0A, 0x08, 0x00,
+  0x00, 0x54, 0x41, 0x01, 0x00, 0x00, 0x00, 0x00, 0x50, 0x54, 0x01, 0x00, 0x00, 0xAA, 0x2A, 0x00,
+  0x00, 0x02, 0x08, 0x00, 0x00, 0x15, 0x00, 0x05, 0x00, 0x00, 0x00, 0x00, 0x50, 0x40, 0x05, 0x00,
+  0x00, 0x82, 0x02, 0x00, 0x00, 0x02, 0x0A, 0x00, 0x40, 0x05, 0x00, 0x05, 0x00, 0x00, 0x00, 0x00,
+  0x14, 0x00, 0x15, 0x00, 0x00, 0x88, 0x02, 0x00, 0x00, 0x88, 0x0A, 0x00, 0x50, 0x01, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x54, 0x00, 0x00, 0x88, 0x02, 0x00, 0x00, 0xA8, 0x02, 0x00,
+  0x50, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x50, 0x00, 0x00, 0xA0, 0x02, 0x00,
+  0x00, 0x2A, 0x02, 0x00, 0x14, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, 0x01,
+  0x00, 0x80, 0x02, 0x00, 0x00, 0x02, 0x48, 0x05, 0x15, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x40, 0x05, 0x10, 0x80, 0x02, 0x00, 0x00, 0x02, 0x48, 0x55, 0x05, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x15, 0x00, 0x00, 0x00, 0x00, 0xA8, 0x02, 0x50,
+  0x05, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x54, 0x05, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x50, 0x55, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x55,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x50, 0x50, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x50, 0x55, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x54, 0x40, 0x01, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x50, 0x40, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x14,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, 0x01, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x14, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40,
+  0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00, 0xA0, 0x00, 0x00, 0x05,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00,
+  0x00, 0x0A, 0x00, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x05, 0x80, 0xAA, 0x00, 0x00, 0x28, 0x00, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00, 0x54, 0x01, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x05, 0x80, 0x82, 0x02, 0x00, 0x20, 0x00, 0x05, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x55, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x0A, 0xA0, 0xA2, 0x54, 0x55,
+  0x05, 0x00, 0x00, 0x00, 0x00, 0x05, 0x05, 0x00, 0x00, 0x00, 0x00, 0x54, 0x55, 0x01, 0x00, 0x0A,
+  0x28, 0xA0, 0x54, 0x55, 0x05, 0x00, 0x00, 0x00, 0x00, 0x05, 0x05, 0x00, 0x00, 0x00, 0x00, 0x54,
+  0x55, 0x01, 0x00, 0x0A, 0x28, 0xA0, 0x00, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00, 0x55, 0x05, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x05, 0x00, 0xA8, 0x02, 0x28, 0xA0, 0x00, 0x05, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x54, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x00, 0xA0, 0x00, 0x28, 0x28, 0x00, 0x05,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x00, 0x80, 0x02,
+  0xA0, 0x0A, 0x00, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x05, 0x00, 0x82, 0x02, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x05, 0x00, 0xA8, 0x00, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x14,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, 0x01, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x14, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40,
+  0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x14, 0x50, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x40, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x50, 0x55, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x50, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x50,
+  0x05, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x54, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x55, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x15, 0x14,
+  0x00, 0x00, 0x00, 0x00, 0xAA, 0x82, 0x0A, 0x05, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x55, 0x05, 0x00, 0x00, 0x00, 0x00, 0x28, 0x20, 0x20, 0x00, 0x15, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, 0x15, 0x00, 0x00, 0x00, 0x00, 0x28, 0x28, 0xA0, 0x00,
+  0x14, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, 0x55, 0x00, 0x00, 0x00, 0x00,
+  0x28, 0x28, 0xA0, 0x00, 0x50, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x50, 0x40,
+  0x01, 0x00, 0x00, 0x00, 0x28, 0x28, 0xA0, 0x00, 0x50, 0x01, 0x40, 0x01, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x54, 0x00, 0x00, 0x00, 0x00, 0x00, 0x28, 0x28, 0xA0, 0x00, 0x40, 0x05, 0x50, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x15, 0x00, 0xAA, 0x2A, 0x00, 0x00, 0x28, 0x28, 0xA0, 0x00,
+  0x00, 0x15, 0x50, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, 0x05, 0x00, 0x08, 0x20, 0x00, 0x00,
+  0x28, 0x28, 0xA0, 0x00, 0x00, 0x54, 0x15, 0x00, 0x00, 0x00, 0x00, 0x00, 0x14, 0x54, 0x01, 0x00,
+  0xA0, 0x00, 0x00, 0x00, 0x2A, 0x20, 0x20, 0x00, 0x00, 0x50, 0x15, 0x00, 0x00, 0x50, 0x00, 0x00,
+  0x14, 0x55, 0x00, 0x00, 0x80, 0x02, 0x00, 0x00, 0x28, 0x80, 0x0A, 0x00, 0x00, 0x00, 0x55, 0x00,
+  0x00, 0x50, 0x00, 0x00, 0x50, 0x05, 0x00, 0x00, 0x00, 0x0A, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x40, 0x55, 0x01, 0x00, 0x50, 0x00, 0x00, 0x54, 0x01, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x40, 0x41, 0x55, 0x01, 0x50, 0x00, 0x54, 0x55, 0x01, 0x00, 0x00,
+  0x00, 0x28, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x55, 0x55, 0x55, 0x55, 0x55,
+  0x45, 0x01, 0x00, 0x00, 0x02, 0x28, 0x00, 0x00, 0x00, 0x00, 0x00, 0xA0, 0xAA, 0xAA, 0x0A, 0x00,
+  0x55, 0x55, 0x55, 0x05, 0x00, 0x00, 0x00, 0x00, 0x0A, 0x2A, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x0A, 0xA0, 0x00, 0x00, 0x00, 0x50, 0x00, 0x00, 0x00, 0xA8, 0x2A, 0x00, 0xA8, 0x0A, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x0A, 0xA0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x02, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0A, 0xA0, 0x00, 0x00, 0xAA, 0xAA, 0xAA, 0x02,
+  0x00, 0x80, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0A, 0xA0, 0x00, 0x00,
+  0xA0, 0x80, 0x00, 0x02, 0x00, 0x80, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x0A, 0xA0, 0x00, 0x00, 0xA0, 0x00, 0x0A, 0x00, 0x00, 0x80, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x0A, 0xA0, 0x00, 0x00, 0xA0, 0x00, 0x28, 0x00, 0x00, 0x80, 0x02, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x20, 0x0A, 0xA2, 0x00, 0x00, 0xA0, 0x00, 0xA0, 0x00,
+  0x00, 0x80, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x0A, 0xA8, 0x00, 0x00,
+  0xA0, 0x00, 0x80, 0x00, 0x00, 0x88, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x0A, 0xA0, 0x00, 0x00, 0xA0, 0x00, 0x80, 0x02, 0x00, 0xA0, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xA2, 0x20, 0x80, 0x02, 0x00, 0x80, 0x02, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xA8, 0xA0, 0xA0, 0x02,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0xA0, 0x80, 0xAA, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+};
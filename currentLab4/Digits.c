@@ -0,0 +1,90 @@
+// -------------------------------------------------------------------
+// File name: Digits.c
+// Description: Digital clock readout drawn from a cache of pre-rendered
+//              digit sprites. Each glyph of the driver's 5x7 font is
+//              expanded once at startup to a 6 by 8 RGB565 image, the cell
+//              ST7735_OutUDec draws, so a character costs one
+//              ST7735_DrawBitmap instead of a pixel by pixel walk through
+//              the font. The text lands where outputTime and outputTimer
+//              put it.
+//------------------------------------------------------------------------------
+#include <stdint.h>
+#include "ST7735.h"
+#include "Tiles.h"
+#include "Digits.h"
+#include "Text.h"
+
+#define DIGIT_W   6                 // 5 columns plus one blank
+#define DIGIT_H   8                 // 7 rows plus one blank
+#define FG_COLOR  ST7735_WHITE
+#define BG_COLOR  ST7735_BLACK
+#define TIME_X    36                // where outputTime put the cursor, column 6
+#define TIMER_X   48                // and outputTimer, column 8
+
+#define GLYPH_COLON 10
+#define GLYPH_POINT 11
+#define GLYPHS      12
+
+// character code of each sprite
+static const char Code[GLYPHS] = {'0','1','2','3','4','5','6','7','8','9',':','.'};
+
+// ST7735_DrawBitmap wants the bottom row first, 1152 bytes
+static uint16_t Sprite[GLYPHS][DIGIT_W*DIGIT_H];
+uint32_t Digits_Blits;
+
+void Digits_Init(void){
+  for(int g = 0; g < GLYPHS; g++){
+    for(int y = 0; y < DIGIT_H; y++){
+      for(int x = 0; x < DIGIT_W; x++){
+        uint16_t color = BG_COLOR;
+        if((x < 5) && (Text_Font[Code[g]*5 + x] & (1 << y))){
+          color = FG_COLOR;
+        }
+        Sprite[g][(DIGIT_H-1-y)*DIGIT_W + x] = color;
+      }
+    }
+  }
+}
+
+void Digits_OutString(int16_t x, int16_t y, const char *pt){
+  while(*pt){
+    int g = -1;
+    if((*pt >= '0') && (*pt <= '9')){
+      g = *pt - '0';
+    } else if(*pt == ':'){
+      g = GLYPH_COLON;
+    } else if(*pt == '.'){
+      g = GLYPH_POINT;
+    }
+    if(g >= 0){                     // bitmap is placed by its lower left corner
+      ST7735_DrawBitmap(x, y + DIGIT_H - 1, Sprite[g], DIGIT_W, DIGIT_H);
+      Digits_Blits++;
+    } else{
+      ST7735_FillRect(x, y, DIGIT_W, DIGIT_H, BG_COLOR);
+    }
+    x = x + DIGIT_W;
+    pt++;
+  }
+}
+
+void Digits_OutTime(int t, int row){
+  char buf[9];
+  int h = (t/3600)%12, m = (t%3600)/60, s = t%60;
+  if(h == 0){
+    h = 12;
+  }
+  buf[0] = '0' + h/10; buf[1] = '0' + h%10; buf[2] = ':';
+  buf[3] = '0' + m/10; buf[4] = '0' + m%10; buf[5] = ':';
+  buf[6] = '0' + s/10; buf[7] = '0' + s%10; buf[8] = 0;
+  Digits_OutString(TIME_X, 10*row, buf);
+}
+
+void Digits_OutTimer(int t, int row){
+  char buf[10];
+  int m = (t/60000)%100, s = (t/1000)%60, ms = t%1000;
+  buf[0] = '0' + m/10; buf[1] = '0' + m%10; buf[2] = ':';
+  buf[3] = '0' + s/10; buf[4] = '0' + s%10; buf[5] = '.';
+  buf[6] = '0' + ms/100; buf[7] = '0' + (ms/10)%10; buf[8] = '0' + ms%10;
+  buf[9] = 0;
+  Digits_OutString(TIMER_X, 10*row, buf);
+}
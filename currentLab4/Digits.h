@@ -0,0 +1,34 @@
+// -------------------------------------------------------------------
+// File name: Digits.h
+// Description: Digital clock readout drawn from a cache of pre-rendered
+//              digit sprites, one ST7735_DrawBitmap per character
+//------------------------------------------------------------------------------
+#include <stdint.h>
+
+// bitmaps (one address window and burst write each) sent since reset
+extern uint32_t Digits_Blits;
+
+//------------Digits_Init------------
+// Expand the '0'-'9', ':' and '.' glyphs into RGB565 sprites, call once at startup
+// Input: none
+// Output: none
+void Digits_Init(void);
+
+//------------Digits_OutTime------------
+// Draw hh:mm:ss from text column 6 of a row, as outputTime did
+// Input: t seconds since midnight, row text row (0 to 15, 10 pixels each)
+// Output: none
+void Digits_OutTime(int t, int row);
+
+//------------Digits_OutTimer------------
+// Draw a stopwatch reading as mm:ss.mmm from text column 8 of a row
+// Input: t elapsed milliseconds, row text row (0 to 15, 10 pixels each)
+// Output: none
+void Digits_OutTimer(int t, int row);
+
+//------------Digits_OutString------------
+// Draw a string of digits, ':' and '.' from the sprite cache, other characters
+// are left blank
+// Input: x,y top left corner in pixels, pt null-terminated string
+// Output: none
+void Digits_OutString(int16_t x, int16_t y, const char *pt);
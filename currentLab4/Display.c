@@ -0,0 +1,204 @@
+// -------------------------------------------------------------------
+// File name: Display.c
+// Description: Display command queue in front of the ST7735. Drawing calls
+//              are queued without touching SPI and the main loop sends them
+//              one at a time with interrupts enabled, between events.
+//              Only the main loop uses the queue, so it needs no locking.
+//------------------------------------------------------------------------------
+#include <stdint.h>
+#include "ST7735.h"
+#include "Tiles.h"
+#include "Display.h"
+#include "Text.h"
+#include "Fill.h"
+#include "Event.h"
+
+#define CMD_FILLRECT  0
+#define CMD_STRING    1
+#define CMD_LINE      2
+#define CMD_CALL      3
+
+typedef struct cmd_t {
+  uint8_t  type;              // CMD_xxx
+  uint16_t color;
+  int16_t  x, y, w, h;        // area the command covers, in pixels
+  union {
+    struct { int16_t x0, y0, x1, y1; } line;
+    struct { char text[DISPLAY_TEXTSIZE]; } str;
+    struct { void (*fn)(int a, int b); int a, b; } call;
+  } u;
+} cmd_t;
+
+#define CMDSIZE 16              // must be a power of 2
+static cmd_t CmdFifo[CMDSIZE];
+static uint32_t CmdPutI;        // index of where to put next
+static uint32_t CmdGetI;        // index of where to get next
+
+uint32_t Display_MaxDepth;
+uint32_t Display_Coalesced;
+uint32_t Display_Bytes;
+
+#ifdef DISPLAY_TILES
+#define SENT(bytes)             // counted when the tiles are flushed
+#else
+#define SENT(bytes) Display_Bytes += (bytes)
+#endif
+
+static int Waiting;             // set by Display_Flush, fills are not left running
+
+#ifndef DISPLAY_TILES
+// called from the SSI0 interrupt, wakes the main loop to send the next command
+static void FillDone(void){
+  Event_Post(EVENT_FILL, 0, 0);
+}
+#endif
+
+static void Execute(cmd_t *c){
+  switch(c->type){
+    case CMD_FILLRECT:
+#ifdef DISPLAY_TILES
+      ST7735_FillRect(c->x, c->y, c->w, c->h, c->color);
+#else
+      if(Waiting){
+        Fill_Rect(c->x, c->y, c->w, c->h, c->color);
+      } else{                   // uDMA sends it, main sleeps until EVENT_FILL
+        Fill_Start(c->x, c->y, c->w, c->h, c->color, &FillDone);
+      }
+#endif
+      SENT(2*c->w*c->h);
+      break;
+    case CMD_STRING:
+      Text_DrawString(c->x, c->y, c->u.str.text, c->color, ST7735_BLACK);
+      SENT(2*c->w*c->h);
+      break;
+    case CMD_LINE:
+      if(c->u.line.y0 == c->u.line.y1){
+        ST7735_DrawFastHLine(c->x, c->y, c->w, c->color);
+        SENT(2*c->w);
+      } else if(c->u.line.x0 == c->u.line.x1){
+        ST7735_DrawFastVLine(c->x, c->y, c->h, c->color);
+        SENT(2*c->h);
+      } else{                   // Bresenham
+        int x = c->u.line.x0, y = c->u.line.y0;
+        int dx = c->u.line.x1 - x, dy = c->u.line.y1 - y;
+        int sx = (dx > 0) ? 1 : -1, sy = (dy > 0) ? 1 : -1;
+        int ax = dx*sx, ay = dy*sy, err = ax - ay, e2;
+        while(1){
+          ST7735_DrawPixel(x, y, c->color);
+          SENT(2);
+          if((x == c->u.line.x1) && (y == c->u.line.y1)) break;
+          e2 = 2*err;
+          if(e2 > -ay){ err -= ay; x += sx; }
+          if(e2 < ax){ err += ax; y += sy; }
+        }
+      }
+      break;
+    case CMD_CALL:
+      c->u.call.fn(c->u.call.a, c->u.call.b);
+      break;
+  }
+}
+
+// Get a free slot at the end of the queue. An opaque command hides every
+// queued command whose area it covers, those are removed first. If the queue
+// is full the oldest command is sent right away to make room.
+static cmd_t *NewCmd(int16_t x, int16_t y, int16_t w, int16_t h, int opaque){
+  cmd_t *c;
+  uint32_t i, j;
+  if(opaque){
+    for(i = j = CmdGetI; i != CmdPutI; i++){
+      c = &CmdFifo[i & (CMDSIZE-1)];
+      if((c->type != CMD_CALL) && (c->x >= x) && (c->y >= y) &&
+         (c->x + c->w <= x + w) && (c->y + c->h <= y + h)){
+        Display_Coalesced++;
+        continue;               // drawn over later, never send it
+      }
+      if(i != j){
+        CmdFifo[j & (CMDSIZE-1)] = *c;
+      }
+      j++;
+    }
+    CmdPutI = j;
+  }
+  while((CmdPutI - CmdGetI) >= CMDSIZE){
+    Display_Drain();            // full, fall back to drawing now
+  }
+  c = &CmdFifo[CmdPutI & (CMDSIZE-1)];
+  CmdPutI++;
+  if((CmdPutI - CmdGetI) > Display_MaxDepth){
+    Display_MaxDepth = CmdPutI - CmdGetI;
+  }
+  c->x = x; c->y = y; c->w = w; c->h = h;
+  return c;
+}
+
+void Display_FillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color){
+  cmd_t *c = NewCmd(x, y, w, h, 1);
+  c->type = CMD_FILLRECT;
+  c->color = color;
+}
+
+void Display_String(uint16_t x, uint16_t y, const char *pt, uint16_t color){
+  cmd_t *c;
+  int n = 0;
+  while(pt[n] && (n < DISPLAY_TEXTSIZE-1)){
+    n++;
+  }
+  c = NewCmd(6*x, 10*y, 6*n, 8, 1);   // 6 by 8 cells, black behind the text
+  c->type = CMD_STRING;
+  c->color = color;
+  for(int i = 0; i < n; i++){
+    c->u.str.text[i] = pt[i];
+  }
+  c->u.str.text[n] = 0;
+}
+
+void Display_Line(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color){
+  int16_t x = (x0 < x1) ? x0 : x1, y = (y0 < y1) ? y0 : y1;
+  cmd_t *c = NewCmd(x, y, ((x0 < x1) ? x1-x0 : x0-x1) + 1,
+                          ((y0 < y1) ? y1-y0 : y0-y1) + 1, 0);
+  c->type = CMD_LINE;
+  c->color = color;
+  c->u.line.x0 = x0; c->u.line.y0 = y0;
+  c->u.line.x1 = x1; c->u.line.y1 = y1;
+}
+
+void Display_Call(void (*fn)(int a, int b), int a, int b){
+  cmd_t *c = NewCmd(0, 0, 0, 0, 0);
+  c->type = CMD_CALL;
+  c->u.call.fn = fn;
+  c->u.call.a = a;
+  c->u.call.b = b;
+}
+
+uint32_t Display_Drain(void){
+  if(Fill_Busy()){
+    return 0;                   // SSI0 is busy with a fill, wait for EVENT_FILL
+  }
+  if(CmdGetI != CmdPutI){
+    Execute(&CmdFifo[CmdGetI & (CMDSIZE-1)]);
+    CmdGetI++;
+#ifdef DISPLAY_TILES
+    return (CmdPutI - CmdGetI) + 1;   // then look for dirty tiles
+#endif
+  }
+#ifdef DISPLAY_TILES
+  else{                         // queue empty, send one changed tile
+    uint32_t sent = Tiles_Sent;
+    uint32_t left = Tiles_Flush();
+    Display_Bytes += (Tiles_Sent - sent)*TILE_BYTES;
+    return left;
+  }
+#endif
+  return CmdPutI - CmdGetI;
+}
+
+uint32_t Display_Pending(void){
+  return (CmdPutI - CmdGetI) + Fill_Busy();
+}
+
+void Display_Flush(void){
+  Waiting = 1;                  // may run with interrupts disabled at startup
+  while(Fill_Busy() || Display_Drain()){};
+  Waiting = 0;
+}
@@ -0,0 +1,68 @@
+// -------------------------------------------------------------------
+// File name: Display.h
+// Description: Display command queue in front of the ST7735. Drawing calls
+//              are queued without touching SPI and the main loop sends them
+//              one at a time with interrupts enabled, between events.
+//------------------------------------------------------------------------------
+#include <stdint.h>
+
+// deepest the queue has been, and commands dropped because a later
+// command drew over the same area before they were sent
+extern uint32_t Display_MaxDepth;
+extern uint32_t Display_Coalesced;
+
+// bytes of pixel data sent to the ST7735 by queued fills, strings and
+// lines; Display_Call routines are counted by their own modules. With
+// DISPLAY_TILES it is every byte sent, counted as the tiles are flushed.
+extern uint32_t Display_Bytes;
+
+//------------Display_FillRect------------
+// Queue a filled rectangle
+// Input: x,y top left corner in pixels, w,h size in pixels, 16-bit color
+// Output: none
+void Display_FillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+
+//------------Display_String------------
+// Queue a string drawn like ST7735_DrawString, on a black background, sent
+// with Text_DrawString as one bitmap for the line
+// Input: x column (0 to 20), y row (0 to 15), pt string (copied, at most
+//        DISPLAY_TEXTSIZE-1 characters are kept), 16-bit text color
+// Output: none
+#define DISPLAY_TEXTSIZE 12
+void Display_String(uint16_t x, uint16_t y, const char *pt, uint16_t color);
+
+//------------Display_Line------------
+// Queue a one pixel wide line
+// Input: x0,y0 and x1,y1 end points in pixels, 16-bit color
+// Output: none
+void Display_Line(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color);
+
+//------------Display_Call------------
+// Queue a call to a drawing routine that talks to the ST7735 itself, such
+// as outputTime, so that it runs in order with the other queued commands
+// Input: fn routine, a and b its two arguments
+// Output: none
+void Display_Call(void (*fn)(int a, int b), int a, int b);
+
+//------------Display_Drain------------
+// Send the oldest queued command to the ST7735, called from the main loop.
+// Fills are sent by uDMA with Fill_Start, nothing else is sent until the
+// last one is done; its completion posts EVENT_FILL, so the main loop can
+// sleep in Event_Wait meanwhile.
+// Input: none
+// Output: number of commands that could be sent now, 0 while a fill is
+//         in progress
+uint32_t Display_Drain(void);
+
+//------------Display_Pending------------
+// Input: none
+// Output: number of commands not yet on the screen, counting a fill in
+//         progress
+uint32_t Display_Pending(void);
+
+//------------Display_Flush------------
+// Send every queued command before returning. Fills are sent by the CPU,
+// so this also works with interrupts disabled at startup.
+// Input: none
+// Output: none
+void Display_Flush(void);
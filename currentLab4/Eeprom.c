@@ -0,0 +1,64 @@
+// -------------------------------------------------------------------
+// File name: Eeprom.c
+// Description: TM4C123 on-chip EEPROM, 2 KB as 32 blocks of 16 words.
+//              Word addresses are split into block and offset; EERDWRINC
+//              steps the offset so a run of words inside one block needs
+//              a single block select.
+//------------------------------------------------------------------------------
+#include <stdint.h>
+#include "tm4c123gh6pm.h"
+#include "Eeprom.h"
+
+#define EEPROM_WORDS  512
+#define BLOCK_WORDS   16
+
+static void Wait(void){
+  while(EEPROM_EEDONE_R & EEPROM_EEDONE_WORKING){};
+}
+
+static void Select(uint32_t addr){
+  EEPROM_EEBLOCK_R = addr/BLOCK_WORDS;
+  EEPROM_EEOFFSET_R = addr%BLOCK_WORDS;
+}
+
+static void Read(uint32_t addr, uint32_t *data, uint32_t n){
+  for(uint32_t i = 0; i < n; i++, addr++){
+    if((i == 0) || ((addr%BLOCK_WORDS) == 0)){
+      Select(addr);
+    }
+    data[i] = EEPROM_EERDWRINC_R;
+  }
+}
+
+static int Write(uint32_t addr, const uint32_t *data, uint32_t n){
+  for(uint32_t i = 0; i < n; i++, addr++){
+    if((i == 0) || ((addr%BLOCK_WORDS) == 0)){
+      Select(addr);
+    }
+    EEPROM_EERDWRINC_R = data[i];
+    Wait();                     // about 110 us per word
+    if(EEPROM_EEDONE_R){        // any bit left set is an error
+      return -1;
+    }
+  }
+  return 0;
+}
+
+const storage_t Eeprom_Storage = {EEPROM_WORDS, &Read, &Write};
+
+int Eeprom_Init(void){
+  SYSCTL_RCGCEEPROM_R |= SYSCTL_RCGCEEPROM_R0;   // 1) activate EEPROM
+  while((SYSCTL_PREEPROM_R&SYSCTL_PREEPROM_R0) == 0){};  // 2) wait until ready
+  Wait();                                         // 3) power-on recovery
+  if(EEPROM_EESUPP_R & (EEPROM_EESUPP_PRETRY|EEPROM_EESUPP_ERETRY)){
+    return -1;
+  }
+  SYSCTL_SREEPROM_R = SYSCTL_SREEPROM_R0;         // 4) reset the module
+  SYSCTL_SREEPROM_R = 0;
+  while((SYSCTL_PREEPROM_R&SYSCTL_PREEPROM_R0) == 0){};
+  Wait();
+  if(EEPROM_EESUPP_R & (EEPROM_EESUPP_PRETRY|EEPROM_EESUPP_ERETRY)){
+    return -1;
+  }
+  return 0;
+}
@@ -0,0 +1,14 @@
+// -------------------------------------------------------------------
+// File name: Eeprom.h
+// Description: TM4C123 on-chip EEPROM, 2 KB as 32 blocks of 16 words
+//------------------------------------------------------------------------------
+#include <stdint.h>
+#include "Storage.h"
+
+extern const storage_t Eeprom_Storage;
+
+//------------Eeprom_Init------------
+// Power up the EEPROM module and let it finish any interrupted write
+// Input: none
+// Output: 0 if the EEPROM is ready, -1 if it reported an error
+int Eeprom_Init(void);
@@ -0,0 +1,72 @@
+// -------------------------------------------------------------------
+// File name: Event.c
+// Description: Event queue between the interrupt handlers and the main loop.
+//              Interrupts post events, main sleeps in Event_Wait until one
+//              is pending and dispatches it.
+//------------------------------------------------------------------------------
+#include <stdint.h>
+#include "Fifo.h"
+#include "Event.h"
+#include "Profile.h"
+
+void DisableInterrupts(void);   // Defined in startup.s
+void EnableInterrupts(void);    // Defined in startup.s
+void WaitForInterrupt(void);    // Defined in startup.s
+long StartCritical (void);      // previous I bit, disable interrupts
+void EndCritical(long sr);      // restore I bit to previous value
+
+// several interrupts post, so Event_Post masks interrupts around the put;
+// main is the only consumer
+#define EVENTSIZE 16            // must be a power of 2
+AddIndexFifo(Event, EVENTSIZE, event_t, 1, 0)
+
+volatile uint32_t Event_Wakeups;
+volatile uint32_t Event_Dispatches;
+volatile uint32_t Event_Dropped;
+
+void Event_Init(void){
+  long sr = StartCritical();
+  EventFifo_Init();
+  Event_Wakeups = Event_Dispatches = Event_Dropped = 0;
+  EndCritical(sr);
+}
+
+int Event_Post(uint8_t type, uint32_t value, uint8_t num){
+  event_t e;
+  long sr;
+  uint32_t masked;
+  int ok;
+  e.type = type;
+  e.value = value;
+  e.num = num;
+  sr = StartCritical();         // main and several ISRs may post
+  masked = Profile_Start();
+  ok = EventFifo_Put(e);
+  if(ok == 0){
+    Event_Dropped++;            // full
+  }
+  Profile_Stop(PROF_MASKED, masked);
+  EndCritical(sr);
+  return ok;
+}
+
+int Event_Get(event_t *e){
+  if(EventFifo_Get(e) == 0){
+    return 0;                   // empty
+  }
+  Event_Dispatches++;
+  return 1;
+}
+
+void Event_Wait(volatile int *flag){
+// WFI still wakes on a pending interrupt with I=1, so testing the queue with
+// interrupts disabled cannot miss a post made just before going to sleep
+  DisableInterrupts();
+  while((EventFifo_Size() == 0) && (*flag == 0)){
+    WaitForInterrupt();         // low power mode
+    EnableInterrupts();         // let the pending ISR run
+    Event_Wakeups++;
+    DisableInterrupts();
+  }
+  EnableInterrupts();
+}
@@ -0,0 +1,43 @@
+// -------------------------------------------------------------------
+// File name: Event.h
+// Description: Event queue between the interrupt handlers and the main loop.
+//              Interrupts post events, main sleeps in Event_Wait until one
+//              is pending and dispatches it.
+//------------------------------------------------------------------------------
+#include <stdint.h>
+
+#define EVENT_SECOND   0    // SysTick advanced the clock by one second
+#define EVENT_MESSAGE  1    // Timer2 put a Blynk message in the receive ring
+#define EVENT_FRAME    2    // 100 ms refresh while an animated readout is shown
+#define EVENT_FILL     3    // uDMA finished a queued fill, SSI0 is free again
+
+typedef struct event_t {
+  uint8_t  type;            // EVENT_xxx
+  uint8_t  num;             // virtual pin, if the event has one
+  uint32_t value;           // value that came with the event
+} event_t;
+
+// Number of times the CPU woke from WaitForInterrupt and events dispatched
+extern volatile uint32_t Event_Wakeups;
+extern volatile uint32_t Event_Dispatches;
+extern volatile uint32_t Event_Dropped;   // posts lost because the queue was full
+
+// ------------------------------ Event_Init ------------------------------------
+// Empty the queue and clear the counters
+void Event_Init(void);
+
+// ------------------------------ Event_Post ------------------------------------
+// Add an event to the queue, callable from main or any interrupt
+// Input: type, value and virtual pin number of the event
+// Output: 1 if queued, 0 if the queue was full
+int Event_Post(uint8_t type, uint32_t value, uint8_t num);
+
+// ------------------------------ Event_Get -------------------------------------
+// Remove the oldest event, called only from the main loop
+// Output: 1 and *e filled if an event was pending, 0 if empty
+int Event_Get(event_t *e);
+
+// ------------------------------ Event_Wait ------------------------------------
+// Sleep with WaitForInterrupt until an event is queued or *flag is set by an
+// interrupt that does not post events (SysTick sets secFlag)
+void Event_Wait(volatile int *flag);
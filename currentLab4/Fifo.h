@@ -0,0 +1,89 @@
+// -------------------------------------------------------------------
+// File name: Fifo.h
+// Description: Index FIFO generator in the style of Valvano's FIFO.h.
+//              AddIndexFifo(NAME,SIZE,TYPE,SUCCESS,FAIL) makes a queue of
+//              SIZE elements of TYPE with
+//                NAMEFifo_Init, NAMEFifo_Put, NAMEFifo_Get, NAMEFifo_Size,
+//                NAMEFifo_PutN, NAMEFifo_GetN, NAMEFifo_PeekN and
+//                NAMEFifo_Skip
+//              SIZE must be a power of 2. The indices run freely and are
+//              masked on use, so all SIZE elements can be filled. With one
+//              producer and one consumer (main and one interrupt) no locks
+//              are needed: only the producer writes PutI and only the
+//              consumer writes GetI, each after the data it covers.
+//              PutN/GetN copy up to n elements in at most two contiguous
+//              spans and move the index once. PeekN copies like GetN but
+//              leaves the elements queued, for a consumer that removes
+//              them with Skip only once it is done with them.
+//------------------------------------------------------------------------------
+#include <stdint.h>
+
+#ifndef FIFO_H
+#define FIFO_H
+// keep the compiler from moving element copies past the index update
+#if defined(__ARMCC_VERSION)
+#define FIFO_BARRIER() __schedule_barrier()
+#else
+#define FIFO_BARRIER() __asm volatile("" ::: "memory")
+#endif
+
+#define AddIndexFifo(NAME,SIZE,TYPE,SUCCESS,FAIL) \
+static volatile uint32_t NAME ## PutI; \
+static volatile uint32_t NAME ## GetI; \
+static TYPE NAME ## Fifo [SIZE]; \
+void NAME ## Fifo_Init(void){ \
+  NAME ## PutI = NAME ## GetI = 0; \
+} \
+int NAME ## Fifo_Put(TYPE data){ \
+  if((NAME ## PutI - NAME ## GetI) & ~(SIZE-1)){ \
+    return(FAIL); \
+  } \
+  NAME ## Fifo[NAME ## PutI & (SIZE-1)] = data; \
+  FIFO_BARRIER(); \
+  NAME ## PutI++; \
+  return(SUCCESS); \
+} \
+int NAME ## Fifo_Get(TYPE *datapt){ \
+  if(NAME ## PutI == NAME ## GetI){ \
+    return(FAIL); \
+  } \
+  *datapt = NAME ## Fifo[NAME ## GetI & (SIZE-1)]; \
+  FIFO_BARRIER(); \
+  NAME ## GetI++; \
+  return(SUCCESS); \
+} \
+uint32_t NAME ## Fifo_Size(void){ \
+  return ((uint32_t)(NAME ## PutI - NAME ## GetI)); \
+} \
+uint32_t NAME ## Fifo_PutN(const TYPE *data, uint32_t n){ \
+  uint32_t put = NAME ## PutI, i = put & (SIZE-1), span, k; \
+  uint32_t room = SIZE - (put - NAME ## GetI); \
+  if(n > room) n = room; \
+  span = (n < SIZE - i) ? n : SIZE - i; \
+  for(k = 0; k < span; k++) NAME ## Fifo[i + k] = data[k]; \
+  for(; k < n; k++) NAME ## Fifo[k - span] = data[k]; \
+  FIFO_BARRIER(); \
+  NAME ## PutI = put + n; \
+  return n; \
+} \
+uint32_t NAME ## Fifo_PeekN(TYPE *data, uint32_t n){ \
+  uint32_t get = NAME ## GetI, i = get & (SIZE-1), span, k; \
+  uint32_t size = NAME ## PutI - get; \
+  if(n > size) n = size; \
+  span = (n < SIZE - i) ? n : SIZE - i; \
+  for(k = 0; k < span; k++) data[k] = NAME ## Fifo[i + k]; \
+  for(; k < n; k++) data[k] = NAME ## Fifo[k - span]; \
+  return n; \
+} \
+void NAME ## Fifo_Skip(uint32_t n){ \
+  uint32_t get = NAME ## GetI, size = NAME ## PutI - get; \
+  if(n > size) n = size; \
+  FIFO_BARRIER(); \
+  NAME ## GetI = get + n; \
+} \
+uint32_t NAME ## Fifo_GetN(TYPE *data, uint32_t n){ \
+  n = NAME ## Fifo_PeekN(data, n); \
+  NAME ## Fifo_Skip(n); \
+  return n; \
+}
+#endif
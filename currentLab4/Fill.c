@@ -0,0 +1,192 @@
+// -------------------------------------------------------------------
+// File name: Fill.c
+// Description: Solid color fills on the ST7735, see Fill.h.
+//              ST7735_FillRect sends every pixel as two 8-bit frames, each
+//              one a separate writedata that waits on the FIFO and sets D/C.
+//              Here SSI0 is switched to 16-bit frames for the pixels, so a
+//              pixel is one FIFO write, and D/C is set once per fill. With
+//              Fill_Start, uDMA channel 11 (SSI0 TX) reads the same color
+//              word over and over, 1024 pixels per transfer, and the SSI0
+//              interrupt starts the next transfer until the fill is done.
+//------------------------------------------------------------------------------
+#include <stdint.h>
+#include "tm4c123gh6pm.h"
+#include "ST7735.h"
+#include "Fill.h"
+
+#define DC          (*((volatile uint32_t *)0x40004100))   // PA6, as in ST7735.c
+#define DC_COMMAND  0
+#define DC_DATA     0x40
+#define COLSTART    0           // panel offsets, 0 for the red tab used by
+#define ROWSTART    0           // Output_Init
+#define CASET       0x2A
+#define RASET       0x2B
+#define RAMWR       0x2C
+
+#define CH_SSI0TX   11          // uDMA channel, encoding 0
+#define DMA_MAX     1024        // most transfers per uDMA request
+
+uint32_t Fill_Count;
+uint32_t Fill_Pixels;
+static const fill_port_t *Port;
+static volatile uint32_t Busy;
+static void (*Done)(void);
+
+//------------------------------- SSI0 port -------------------------------------
+static void SsiCommand(uint8_t c){
+  while(SSI0_SR_R&SSI_SR_BSY){};  // parameters of the last command are out
+  DC = DC_COMMAND;
+  SSI0_DR_R = c;
+  while(SSI0_SR_R&SSI_SR_BSY){};
+}
+
+static void SsiData(uint8_t d){
+  while((SSI0_SR_R&SSI_SR_TNF) == 0){};
+  DC = DC_DATA;
+  SSI0_DR_R = d;
+}
+
+// 16-bit frames for pixels, 8-bit frames for ST7735.c. The frame size is
+// only changed with SSI0 idle and disabled.
+static void FrameSize(uint32_t dss){
+  while(SSI0_SR_R&SSI_SR_BSY){};
+  SSI0_CR1_R &= ~SSI_CR1_SSE;
+  SSI0_CR0_R = (SSI0_CR0_R&~SSI_CR0_DSS_M)|dss;
+  SSI0_CR1_R |= SSI_CR1_SSE;
+}
+
+static void SsiPixels(uint16_t color, uint32_t n){
+  FrameSize(SSI_CR0_DSS_16);
+  DC = DC_DATA;
+  while(n){                       // keep the 8 entry TX FIFO full
+    if(SSI0_SR_R&SSI_SR_TNF){
+      SSI0_DR_R = color;
+      n--;
+    }
+  }
+  FrameSize(SSI_CR0_DSS_8);
+}
+
+// primary control structures for channels 0 to 31, only 11 is used
+static uint32_t DmaTable[128] __attribute__((aligned(1024)));
+static uint16_t DmaColor;
+static volatile uint32_t DmaLeft;
+
+static void DmaNext(void){
+  uint32_t n = (DmaLeft > DMA_MAX) ? DMA_MAX : DmaLeft;
+  DmaLeft -= n;
+  DmaTable[4*CH_SSI0TX] = (uint32_t)(uintptr_t)&DmaColor;      // source, not incremented
+  DmaTable[4*CH_SSI0TX+1] = (uint32_t)(uintptr_t)&SSI0_DR_R;   // destination
+  DmaTable[4*CH_SSI0TX+2] = 0xC0000000|0x10000000|  // 16-bit, no increment
+                            0x0C000000|0x01000000|
+                            0x00008000|             // 4 per burst, half a FIFO
+                            ((n-1)<<4)|0x1;         // basic mode
+  UDMA_ENASET_R = 1<<CH_SSI0TX;
+}
+
+static void SsiStart(uint16_t color, uint32_t n){
+  FrameSize(SSI_CR0_DSS_16);
+  DC = DC_DATA;
+  DmaColor = color;
+  DmaLeft = n;
+  DmaNext();
+  SSI0_DMACTL_R |= SSI_DMACTL_TXDMAE;
+}
+
+// uDMA completion for a peripheral channel is signaled on that
+// peripheral's vector, UDMA_CHIS tells which channel finished
+void SSI0_Handler(void){
+  if(UDMA_CHIS_R&(1<<CH_SSI0TX)){
+    UDMA_CHIS_R = 1<<CH_SSI0TX;   // acknowledge
+    if(DmaLeft){
+      DmaNext();
+    } else{
+      SSI0_DMACTL_R &= ~SSI_DMACTL_TXDMAE;
+      FrameSize(SSI_CR0_DSS_8);   // waits out the last frames in the FIFO
+      Fill_Sent();
+    }
+  }
+}
+
+static const fill_port_t Ssi0 = {&SsiCommand, &SsiData, &SsiPixels, &SsiStart};
+
+void Fill_Init(const fill_port_t *port){
+  if(port == 0){
+    SYSCTL_RCGCDMA_R |= 0x01;     // 1) activate uDMA
+    while((SYSCTL_PRDMA_R&0x01) == 0){};
+    UDMA_CFG_R = 0x01;            // 2) master enable
+    UDMA_CTLBASE_R = (uint32_t)(uintptr_t)DmaTable;
+    UDMA_CHMAP1_R &= ~0x0000F000; // 3) channel 11 is SSI0 TX
+    UDMA_PRIOCLR_R = 1<<CH_SSI0TX;
+    UDMA_ALTCLR_R = 1<<CH_SSI0TX; //    primary structure only
+    UDMA_USEBURSTCLR_R = 1<<CH_SSI0TX;
+    UDMA_REQMASKCLR_R = 1<<CH_SSI0TX;
+    NVIC_PRI1_R = (NVIC_PRI1_R&0x00FFFFFF)|0xC0000000;  // 4) priority 6
+    NVIC_EN0_R = 1<<7;            // 5) IRQ 7 is SSI0
+    port = &Ssi0;
+  }
+  Port = port;
+}
+
+// Clip to the screen and open the address window, returns the pixel count
+static uint32_t Window(int16_t x, int16_t y, int16_t w, int16_t h){
+  if(Port == 0){
+    return 0;                     // no display, Fill_Init not called
+  }
+  if(x < 0){ w += x; x = 0; }
+  if(y < 0){ h += y; y = 0; }
+  if(x + w > ST7735_TFTWIDTH) w = ST7735_TFTWIDTH - x;
+  if(y + h > ST7735_TFTHEIGHT) h = ST7735_TFTHEIGHT - y;
+  if((w <= 0) || (h <= 0)){
+    return 0;
+  }
+  Port->command(CASET);
+  Port->data(0x00); Port->data(x + COLSTART);
+  Port->data(0x00); Port->data(x + w - 1 + COLSTART);
+  Port->command(RASET);
+  Port->data(0x00); Port->data(y + ROWSTART);
+  Port->data(0x00); Port->data(y + h - 1 + ROWSTART);
+  Port->command(RAMWR);
+  Fill_Count++;
+  Fill_Pixels += w*h;
+  return w*h;
+}
+
+void Fill_Rect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color){
+  uint32_t n;
+  while(Busy){};                  // a started fill still owns SSI0
+  n = Window(x, y, w, h);
+  if(n){
+    Port->pixels(color, n);
+  }
+}
+
+void Fill_Start(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color,
+                void (*done)(void)){
+  uint32_t n;
+  while(Busy){};
+  n = Window(x, y, w, h);
+  if((n == 0) || (Port->start == 0)){
+    if(n){
+      Port->pixels(color, n);     // port has no uDMA
+    }
+    if(done){
+      done();
+    }
+    return;
+  }
+  Done = done;
+  Busy = 1;
+  Port->start(color, n);
+}
+
+uint32_t Fill_Busy(void){
+  return Busy;
+}
+
+void Fill_Sent(void){
+  Busy = 0;
+  if(Done){
+    Done();
+  }
+}
@@ -0,0 +1,54 @@
+// -------------------------------------------------------------------
+// File name: Fill.h
+// Description: Solid color fills on the ST7735. The address window is set
+//              once and the color is streamed as 16-bit SSI0 frames, either
+//              by the CPU keeping the TX FIFO full or by uDMA while the CPU
+//              does other work. The bytes go through a fill_port_t, so a
+//              host stand-in can count what a fill sends.
+//------------------------------------------------------------------------------
+#include <stdint.h>
+
+typedef struct fill_port_t {
+  void (*command)(uint8_t c);                   // command byte, D/C low
+  void (*data)(uint8_t d);                      // parameter byte, D/C high
+  void (*pixels)(uint16_t color, uint32_t n);   // send n pixels, return when sent
+  void (*start)(uint16_t color, uint32_t n);    // start sending n pixels and call
+                                                // Fill_Sent when they are sent
+} fill_port_t;
+
+// fills and pixels sent since reset
+extern uint32_t Fill_Count;
+extern uint32_t Fill_Pixels;
+
+//------------Fill_Init------------
+// Select the port, call after Output_Init has set up SSI0
+// Input: port to send through, 0 for SSI0 with uDMA channel 11
+// Output: none
+void Fill_Init(const fill_port_t *port);
+
+//------------Fill_Rect------------
+// Fill a rectangle and wait until it is sent, like ST7735_FillRect
+// Input: x,y top left corner in pixels, w,h size in pixels, 16-bit color
+// Output: none
+void Fill_Rect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+
+//------------Fill_Start------------
+// Start filling a rectangle with uDMA and return. SSI0 belongs to the fill
+// until Fill_Busy returns 0, so nothing else may draw until then.
+// Input: x,y top left corner in pixels, w,h size in pixels, 16-bit color,
+//        done routine called from the SSI0 interrupt when the fill is
+//        sent, or 0
+// Output: none
+void Fill_Start(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color,
+                void (*done)(void));
+
+//------------Fill_Busy------------
+// Input: none
+// Output: 1 while a fill started by Fill_Start is still being sent
+uint32_t Fill_Busy(void);
+
+//------------Fill_Sent------------
+// Called by the port when the pixels from start have all been sent
+// Input: none
+// Output: none
+void Fill_Sent(void);
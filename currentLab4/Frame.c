@@ -0,0 +1,78 @@
+// -------------------------------------------------------------------
+// File name: Frame.c
+// Description: Binary records for the TM4C-ESP8266 link, see Frame.h
+//------------------------------------------------------------------------------
+#include <stdint.h>
+#include "Frame.h"
+
+// byte stuffing: ESC followed by the byte XOR ESC_XOR stands for a 0x00,
+// '\n' or ESC in the record
+#define ESC       0x1B
+#define ESC_XOR   0x20
+#define RAWMAX    8         // 0x80|len, pin, 5 varint bytes, CRC
+
+uint32_t Frame_Errors;
+
+uint8_t Frame_Crc8(const uint8_t *pt, uint32_t n){
+  uint8_t crc = 0;
+  while(n--){
+    crc ^= *pt++;
+    for(int i = 0; i < 8; i++){
+      crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+    }
+  }
+  return crc;
+}
+
+char *Frame_Encode(char *pt, uint32_t pin, uint32_t value){
+  uint8_t raw[RAWMAX];
+  uint32_t n = 2;
+  raw[1] = (uint8_t)pin;
+  do{                         // 7 bits at a time, low first, bit 7 means more
+    raw[n++] = (value & 0x7F) | ((value > 0x7F) ? 0x80 : 0);
+    value >>= 7;
+  }while(value);
+  raw[0] = FRAME_FLAG | (n - 1);
+  raw[n] = Frame_Crc8(raw, n);
+  n++;
+  for(uint32_t i = 0; i < n; i++){
+    uint8_t b = raw[i];
+    if((b == 0) || (b == '\n') || (b == ESC)){
+      *pt++ = ESC;
+      b ^= ESC_XOR;
+    }
+    *pt++ = b;
+  }
+  *pt++ = '\n';
+  return pt;
+}
+
+int Frame_Decode(const char *pt, uint32_t n, uint32_t *pin, uint32_t *value){
+  uint8_t raw[RAWMAX];
+  uint32_t len = 0, v = 0, shift = 0, i;
+  const char *end = pt + n;
+  while((pt < end) && *pt && (*pt != '\n')){
+    uint8_t b = *pt++;
+    if(b == ESC){
+      if((pt == end) || !*pt) break;
+      b = *pt++ ^ ESC_XOR;
+    }
+    if(len == RAWMAX){
+      Frame_Errors++;
+      return 0;               // too long
+    }
+    raw[len++] = b;
+  }
+  if((len < 4) || ((raw[0] & 0x7F) != len - 2) ||
+     (Frame_Crc8(raw, len - 1) != raw[len-1])){
+    Frame_Errors++;
+    return 0;
+  }
+  for(i = 2; i < len - 1; i++){
+    v |= (uint32_t)(raw[i] & 0x7F) << shift;
+    shift += 7;
+  }
+  *pin = raw[1];
+  *value = v;
+  return 1;
+}
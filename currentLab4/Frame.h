@@ -0,0 +1,38 @@
+// -------------------------------------------------------------------
+// File name: Frame.h
+// Description: Binary records for the TM4C-ESP8266 link, used in place
+//              of the "pin,value,0.0\n" CSV lines once the ESP8266 has
+//              shown it understands them. A record is
+//                0x80|len, pin, value as a varint, CRC-8
+//              where len counts the pin and varint bytes and the CRC
+//              (polynomial 0x07) covers everything before it. The record
+//              is byte stuffed so it never contains 0x00 or '\n' and is
+//              ended with '\n', so it passes through the line based
+//              ESP8266 driver like a CSV line. The first byte has bit 7
+//              set, which a CSV line never does.
+//------------------------------------------------------------------------------
+#include <stdint.h>
+
+#define FRAME_FLAG  0x80    // set in the first byte of every binary record
+#define FRAME_MAX   18      // longest encoded record, with stuffing and '\n'
+
+// records rejected by Frame_Decode since reset
+extern uint32_t Frame_Errors;
+
+//------------Frame_Crc8------------
+// CRC-8, polynomial x^8+x^2+x+1, initial value 0
+// Input: pt bytes, n how many
+// Output: CRC of the bytes
+uint8_t Frame_Crc8(const uint8_t *pt, uint32_t n);
+
+//------------Frame_Encode------------
+// Write one record, stuffed and ended with '\n', no null terminator
+// Input: pt where to write (room for FRAME_MAX bytes), pin and value
+// Output: pointer just past the '\n'
+char *Frame_Encode(char *pt, uint32_t pin, uint32_t value);
+
+//------------Frame_Decode------------
+// Check and unpack one record
+// Input: pt record as received, ended by '\n' or a null, at most n bytes
+// Output: 1 with *pin and *value filled in, 0 if the record is damaged
+int Frame_Decode(const char *pt, uint32_t n, uint32_t *pin, uint32_t *value);
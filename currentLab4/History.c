@@ -0,0 +1,54 @@
+// -------------------------------------------------------------------
+// File name: History.c
+// Description: Ring of timestamped events and samples kept while the Blynk
+//              link is down or busy, uploaded a few at a time once it is
+//              up. When full the oldest record is overwritten, which moves
+//              the get index, so History_Add runs with interrupts masked;
+//              it is only called from main, so the uploader in Timer3
+//              cannot be interrupted by it and takes records without
+//              masking.
+//------------------------------------------------------------------------------
+#include <stdint.h>
+#include "Timebase.h"
+#include "Fifo.h"
+#include "History.h"
+#include "Profile.h"
+
+long StartCritical (void);      // previous I bit, disable interrupts
+void EndCritical(long sr);      // restore I bit to previous value
+
+AddIndexFifo(Hist, HISTSIZE, history_t, 1, 0)
+
+volatile uint32_t History_Dropped;
+volatile uint32_t History_Sent;
+
+void History_Add(uint32_t type, uint32_t value){
+  history_t h, old;
+  uint32_t sub, masked;
+  long sr;
+  Timebase_Read(&h.stamp, &sub);
+  h.type = type;
+  h.value = value;
+  sr = StartCritical();
+  masked = Profile_Start();
+  if(HistFifo_Put(h) == 0){
+    HistFifo_Get(&old);         // full, lose the oldest
+    History_Dropped++;
+    HistFifo_Put(h);
+  }
+  Profile_Stop(PROF_MASKED, masked);
+  EndCritical(sr);
+}
+
+uint32_t History_Peek(history_t *h, uint32_t n){
+  return HistFifo_PeekN(h, n);
+}
+
+void History_Commit(uint32_t n){
+  HistFifo_Skip(n);
+  History_Sent += n;
+}
+
+uint32_t History_Size(void){
+  return HistFifo_Size();
+}
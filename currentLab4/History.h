@@ -0,0 +1,51 @@
+// -------------------------------------------------------------------
+// File name: History.h
+// Description: Ring of timestamped events and samples kept while the Blynk
+//              link is down or busy, uploaded a few at a time once it is
+//              up. When full the oldest record is overwritten.
+//------------------------------------------------------------------------------
+#include <stdint.h>
+
+#define HIST_BOOT    0      // power on, value 0
+#define HIST_ALARM   1      // alarm fired, value the alarm time in seconds
+#define HIST_LAP     2      // stopwatch stopped, value the reading in ms
+#define HIST_RESET   3      // factory reset from VP0, value 0
+#define HIST_SAMPLE  4      // periodic clock sample, value the time in seconds
+#define HIST_TYPES   5
+
+typedef struct history_t {
+  uint32_t stamp;           // seconds since power on
+  uint32_t type:8;          // HIST_xxx
+  uint32_t value:24;
+} history_t;
+
+#define HISTSIZE 64         // must be a power of 2, 8 bytes each
+
+// records overwritten before they were uploaded, and records uploaded
+extern volatile uint32_t History_Dropped;
+extern volatile uint32_t History_Sent;
+
+//------------History_Add------------
+// Record an event now, called only from main: the uploader in Timer3 takes
+// records without masking, so an interrupt must not add one under it
+// Input: type HIST_xxx, value (24 bits kept)
+// Output: none
+void History_Add(uint32_t type, uint32_t value);
+
+//------------History_Peek------------
+// Copy up to n of the oldest records and leave them in the ring, called
+// only from the uploader
+// Input: h array of n records to fill in
+// Output: number of records copied, 0 if empty
+uint32_t History_Peek(history_t *h, uint32_t n);
+
+//------------History_Commit------------
+// Remove the n oldest records once they have reached the app, called only
+// from the uploader, in the same interrupt as the History_Peek
+// Input: n records delivered
+// Output: none
+void History_Commit(uint32_t n);
+
+//------------History_Size------------
+// Output: number of records waiting
+uint32_t History_Size(void);
@@ -0,0 +1,85 @@
+// -------------------------------------------------------------------
+// File name: Profile.c
+// Description: Cycle counts for the hot paths. Each region keeps a call
+//              count, min, max and total, measured with the Cortex-M4 DWT
+//              cycle counter or any other 32-bit up counter passed to
+//              Profile_Init. A region must only be timed from one context,
+//              except PROF_MASKED, which is stopped before interrupts are
+//              enabled again and so cannot be preempted.
+//------------------------------------------------------------------------------
+#include <stdint.h>
+#include "UART.h"
+#include "Profile.h"
+
+// Cortex-M4 debug registers, not in tm4c123gh6pm.h
+#define DEMCR_R       (*((volatile uint32_t *)0xE000EDFC))
+#define DEMCR_TRCENA  0x01000000   // enable DWT
+#define DWT_CTRL_R    (*((volatile uint32_t *)0xE0001000))
+#define DWT_CTRL_CYCCNTENA 0x00000001
+#define DWT_CYCCNT_R  (*((volatile uint32_t *)0xE0001004))
+
+prof_t Profile[PROF_REGIONS];
+static uint32_t (*Clock)(void);
+static uint32_t Overhead;       // cycles of an empty Start/Stop pair
+
+static const char * const Name[PROF_REGIONS] = {
+  "rx ", "tx ", "phase ", "hands ", "masked ", "parse "
+};
+
+static uint32_t CycleCount(void){
+  return DWT_CYCCNT_R;
+}
+
+void Profile_Init(uint32_t (*clock)(void)){
+  uint32_t i, t;
+  if(clock == 0){
+    DEMCR_R |= DEMCR_TRCENA;
+    DWT_CYCCNT_R = 0;
+    DWT_CTRL_R |= DWT_CTRL_CYCCNTENA;
+    clock = &CycleCount;
+  }
+  Clock = clock;
+  Overhead = 0;
+  t = Profile_Start();
+  Overhead = Clock() - t;       // taken off every measurement
+  for(i = 0; i < PROF_REGIONS; i++){
+    Profile[i].count = 0;
+    Profile[i].min = 0xFFFFFFFF;
+    Profile[i].max = 0;
+    Profile[i].total = 0;
+  }
+}
+
+uint32_t Profile_Start(void){
+  return Clock();
+}
+
+void Profile_Stop(uint32_t region, uint32_t start){
+  prof_t *p = &Profile[region];
+  uint32_t cycles = Clock() - start;  // unsigned difference survives wrap
+  cycles = (cycles > Overhead) ? cycles - Overhead : 0;
+  p->count++;
+  p->total += cycles;
+  if(cycles < p->min) p->min = cycles;
+  if(cycles > p->max) p->max = cycles;
+}
+
+uint32_t Profile_Mean(uint32_t region){
+  prof_t *p = &Profile[region];
+  return p->count ? (uint32_t)(p->total/p->count) : 0;
+}
+
+void Profile_Print(void){
+  uint32_t i;
+  for(i = 0; i < PROF_REGIONS; i++){
+    UART_OutString((char *)Name[i]);
+    UART_OutUDec(Profile[i].count);
+    UART_OutChar(' ');
+    UART_OutUDec(Profile[i].count ? Profile[i].min : 0);
+    UART_OutChar(' ');
+    UART_OutUDec(Profile[i].max);
+    UART_OutChar(' ');
+    UART_OutUDec(Profile_Mean(i));
+    UART_OutString("\n\r");
+  }
+}
@@ -0,0 +1,55 @@
+// -------------------------------------------------------------------
+// File name: Profile.h
+// Description: Cycle counts for the hot paths. Each region keeps a call
+//              count, min, max and total, measured with the Cortex-M4 DWT
+//              cycle counter or any other 32-bit up counter passed to
+//              Profile_Init. A region must only be timed from one context,
+//              except PROF_MASKED, which is stopped before interrupts are
+//              enabled again and so cannot be preempted.
+//------------------------------------------------------------------------------
+#include <stdint.h>
+
+#define PROF_RX       0     // Blynk_to_TM4C, Timer2 ISR
+#define PROF_TX       1     // SendInformation, Timer3 ISR
+#define PROF_PHASE    2     // PhaseControl
+#define PROF_HANDS    3     // drawing the clock hands
+#define PROF_MASKED   4     // every StartCritical/EndCritical section
+#define PROF_PARSE    5     // checking and unpacking one inbound message
+#define PROF_REGIONS  6
+
+typedef struct prof_t {
+  uint32_t count;           // times the region ran
+  uint32_t min, max;        // cycles
+  uint64_t total;           // cycles, mean is total/count
+} prof_t;
+
+extern prof_t Profile[PROF_REGIONS];
+
+//------------Profile_Init------------
+// Clear the statistics and select the clock
+// Input: clock returns a free-running 32-bit count, 0 for the DWT cycle counter
+// Output: none
+void Profile_Init(uint32_t (*clock)(void));
+
+//------------Profile_Start------------
+// Read the clock at the start of a region
+// Input: none
+// Output: value to pass to Profile_Stop
+uint32_t Profile_Start(void);
+
+//------------Profile_Stop------------
+// Add one run of a region to its statistics
+// Input: region PROF_xxx, start value from Profile_Start
+// Output: none
+void Profile_Stop(uint32_t region, uint32_t start);
+
+//------------Profile_Mean------------
+// Input: region PROF_xxx
+// Output: mean cycles per run, 0 if it has not run
+uint32_t Profile_Mean(uint32_t region);
+
+//------------Profile_Print------------
+// Send one line per region (name count min max mean) to the debug UART
+// Input: none
+// Output: none
+void Profile_Print(void);
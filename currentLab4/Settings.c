@@ -0,0 +1,131 @@
+// -------------------------------------------------------------------
+// File name: Settings.c
+// Description: User settings kept across resets in an append-only log of
+//              fixed size records. Each save goes to the next slot around
+//              the store, so wear is spread over all of it, and boot finds
+//              the newest record with a binary search on sequence numbers.
+//------------------------------------------------------------------------------
+#include <stdint.h>
+#include "Settings.h"
+
+// Record layout, RECWORDS words. Record n of the log is written to slot
+// n % Slots, so slot 0 holds the newest multiple of Slots and the slots
+// after it count up by one until the write point.
+#define RECWORDS  5
+#define SEQ       0         // sequence number n, erased reads 0xFFFFFFFF
+#define ALARM     1
+#define PHASE     2
+#define STOPWATCH 3
+#define CHECK     4         // written last, a torn record fails the check
+#define MAGIC     0x5E77C10Cu
+
+uint32_t Settings_Requests;
+uint32_t Settings_Records;
+uint32_t Settings_RestoreReads;
+
+static const storage_t *Store;
+static uint32_t Slots;          // records that fit in the store
+static uint32_t NextSeq;        // sequence number of the next record
+static settings_t Saved;        // contents of the newest record
+static int HaveSaved;           // 0 until a record is found or written
+static settings_t Pending;      // waiting to be written
+static uint32_t Quiet;          // Settings_Poll calls since Pending changed
+static int Dirty;
+
+static uint32_t Check(const uint32_t *r){
+  return MAGIC ^ r[SEQ] ^ (r[ALARM] << 1) ^ (r[PHASE] << 7) ^ (r[STOPWATCH] << 13);
+}
+
+static uint32_t SeqAt(uint32_t slot){
+  uint32_t seq;
+  Store->read(slot*RECWORDS + SEQ, &seq, 1);
+  Settings_RestoreReads++;
+  return seq;
+}
+
+// reads the record in slot, returns 1 if it is whole
+static int Load(uint32_t slot, uint32_t *r){
+  Store->read(slot*RECWORDS, r, RECWORDS);
+  Settings_RestoreReads += RECWORDS;
+  return (r[SEQ] != 0xFFFFFFFF) && (r[CHECK] == Check(r));
+}
+
+static int Same(const settings_t *a, const settings_t *b){
+  return (a->alarm == b->alarm) && (a->phase == b->phase) &&
+         (a->stopwatch == b->stopwatch);
+}
+
+int Settings_Init(const storage_t *store, settings_t *s){
+  uint32_t r[RECWORDS], base, lo, hi, mid, tries;
+  Store = store;
+  Slots = store->words/RECWORDS;
+  Dirty = 0;
+  HaveSaved = 0;
+  NextSeq = 0;
+  Settings_RestoreReads = 0;
+  base = SeqAt(0);
+  if(base == 0xFFFFFFFF){
+    return 0;                   // never written
+  }
+// slots 0 to hi-1 hold base, base+1, ...; find the last one
+  lo = 0; hi = Slots;
+  while(hi - lo > 1){
+    mid = (lo + hi)/2;
+    if(SeqAt(mid) == base + mid){
+      lo = mid;
+    } else{
+      hi = mid;
+    }
+  }
+// the newest record may be torn by a reset during the write, then the one
+// before it is used; older ones wrap around to the end of the store
+  for(tries = 0; tries < 2; tries++){
+    uint32_t slot = (lo + Slots - tries)%Slots;
+    if(Load(slot, r)){
+      NextSeq = r[SEQ] + 1;   // overwrites a torn record
+      Saved.alarm = (int32_t)r[ALARM];
+      Saved.phase = r[PHASE];
+      Saved.stopwatch = r[STOPWATCH];
+      HaveSaved = 1;
+      *s = Saved;
+      return 1;
+    }
+  }
+  NextSeq = base + lo + 1;
+  return 0;
+}
+
+void Settings_Save(const settings_t *s){
+  if(Dirty ? Same(s, &Pending) : (HaveSaved && Same(s, &Saved))){
+    return;
+  }
+  Settings_Requests++;
+  Pending = *s;
+  Dirty = 1;
+  Quiet = 0;
+}
+
+int Settings_Poll(void){
+  uint32_t r[RECWORDS];
+  if(!Dirty || (++Quiet < SETTINGS_QUIET)){
+    return 0;
+  }
+  Dirty = 0;
+  if(HaveSaved && Same(&Pending, &Saved)){
+    return 0;                   // edited back to what is stored
+  }
+  r[SEQ] = NextSeq;
+  r[ALARM] = (uint32_t)Pending.alarm;
+  r[PHASE] = Pending.phase;
+  r[STOPWATCH] = Pending.stopwatch;
+  r[CHECK] = Check(r);
+  if(Store->write((NextSeq%Slots)*RECWORDS, r, RECWORDS)){
+    Dirty = 1;                  // try again next time
+    return 0;
+  }
+  NextSeq++;
+  Saved = Pending;
+  HaveSaved = 1;
+  Settings_Records++;
+  return 1;
+}
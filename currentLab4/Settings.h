@@ -0,0 +1,43 @@
+// -------------------------------------------------------------------
+// File name: Settings.h
+// Description: User settings kept across resets in an append-only log of
+//              fixed size records. Each save goes to the next slot around
+//              the store, so wear is spread over all of it, and boot finds
+//              the newest record with a binary search on sequence numbers.
+//------------------------------------------------------------------------------
+#include <stdint.h>
+#include "Storage.h"
+
+typedef struct settings_t {
+  int32_t  alarm;           // time_alarm, seconds on the 12 hour dial
+  uint32_t phase;           // default_phase, 0 analog+digital, 5 analog, 6 digital
+  uint32_t stopwatch;       // paused stopwatch reading in ms
+} settings_t;
+
+// Cost counters: saves that changed something, records written and storage
+// words read by the last restore
+extern uint32_t Settings_Requests;
+extern uint32_t Settings_Records;
+extern uint32_t Settings_RestoreReads;
+
+//------------Settings_Init------------
+// Find the newest valid record in the store
+// Input: store to use, s filled in from the newest record
+// Output: 1 if s was restored, 0 if the store holds no valid record
+//         (s is left unchanged)
+int Settings_Init(const storage_t *store, settings_t *s);
+
+//------------Settings_Save------------
+// Note that the settings changed. Nothing is written until they have been
+// unchanged for SETTINGS_QUIET calls of Settings_Poll, so a burst of edits
+// becomes one record.
+// Input: s current settings
+// Output: none
+#define SETTINGS_QUIET 3
+void Settings_Save(const settings_t *s);
+
+//------------Settings_Poll------------
+// Write the pending settings once they are quiet, call once a second
+// Input: none
+// Output: 1 if a record was written
+int Settings_Poll(void);
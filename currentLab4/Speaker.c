@@ -4,6 +4,8 @@
 #include "tm4c123gh6pm.h"
 #include "Speaker.h"
 #include "ST7735.h"
+#include "Alarm.h"
+#include "Profile.h"
 #define PF2                     (*((volatile uint32_t *)0x40025010))
 
 int time_alarm = (8*3600 +46*60) + 60;
@@ -11,9 +13,172 @@ int time_alarm = (8*3600 +46*60) + 60;
 int alarm = 0;
 int inAlarm = 0;
 
+static int AlarmId = -1;        // wheel entry of time_alarm
+
+// Move the main (phase 3) alarm to t; it repeats every turn of the dial
+void setAlarm(int t){
+	Alarm_Remove(AlarmId);
+	time_alarm = t;
+	AlarmId = Alarm_Add(t, ALARM_DAILY);
+}
+
+// Called once per second with the clock time; returns 1 if any alarm,
+// countdown or snooze fell due since the last call
 int checkAlarm(int t){
-	if(t == time_alarm){
+	if(Alarm_Tick(t)){
 		return 1;
 	}
 	return 0;
 }
+
+// ------------------------------- Synthesizer ---------------------------------
+// Alarm melodies played on PF2 as M1PWM6. The PWM runs at 80 MHz/256, so
+// its duty cycle is an 8-bit DAC once the speaker filters the carrier out.
+// Timer1A interrupts at SAMPLE_RATE and writes one sample: a 64 entry
+// wavetable stepped by a 32-bit phase accumulator, times an envelope that
+// rises over ATTACK samples and then decays by 1/2048 per sample. Timer1A
+// has the lowest priority, so UART5, Timer2 and Timer3 preempt it.
+#define SAMPLE_RATE   8000
+#define SAMPLE_BUDGET 400       // cycles the sample ISR may take, 4% of the CPU
+#define ATTACK        40        // samples, 5 ms
+#define ENV_MAX       32767
+#define SIXTEENTH     (SAMPLE_RATE/16)
+// phase step of a note, frequency in tenths of a Hz
+#define NOTE(f10)     ((uint32_t)(((uint64_t)(f10) << 32)/(10*SAMPLE_RATE)))
+
+static const int8_t Sine[64] = {
+     0,   12,   25,   37,   49,   60,   71,   81,
+    90,   98,  106,  112,  117,  122,  125,  126,
+   127,  126,  125,  122,  117,  112,  106,   98,
+    90,   81,   71,   60,   49,   37,   25,   12,
+     0,  -12,  -25,  -37,  -49,  -60,  -71,  -81,
+   -90,  -98, -106, -112, -117, -122, -125, -126,
+  -127, -126, -125, -122, -117, -112, -106,  -98,
+   -90,  -81,  -71,  -60,  -49,  -37,  -25,  -12
+};
+// fundamental plus 1/2 second and 1/4 third harmonic, a softer bell
+static const int8_t Bell[64] = {
+     0,   25,   48,   70,   89,  104,  116,  123,
+   127,  127,  123,  117,  108,   99,   88,   78,
+    69,   60,   53,   48,   44,   41,   38,   37,
+    35,   33,   31,   28,   24,   19,   13,    7,
+     0,   -7,  -13,  -19,  -24,  -28,  -31,  -33,
+   -35,  -37,  -38,  -41,  -44,  -48,  -53,  -60,
+   -69,  -78,  -88,  -99, -108, -117, -123, -127,
+  -127, -123, -116, -104,  -89,  -70,  -48,  -25
+};
+
+#define REST 0
+#define C5   1
+#define D5   2
+#define E5   3
+#define G5   4
+#define C6   5
+#define D6   6
+#define E6   7
+#define G6   8
+#define C7   9
+static const uint32_t Step[] = {
+  0, NOTE(5233), NOTE(5873), NOTE(6593), NOTE(7840),
+  NOTE(10465), NOTE(11747), NOTE(13185), NOTE(15680), NOTE(20930)
+};
+
+// note, length in sixteenths of a second; a 0 length repeats the melody
+typedef struct melody_t {
+  const int8_t *wave;
+  uint8_t notes[24];
+} melody_t;
+static const melody_t Melody[] = {
+  {Sine, {C7,2, REST,2, C7,2, REST,2, C7,2, REST,10, 0,0}},          // 0 beeps
+  {Bell, {C6,4, E6,4, G6,4, C7,8, REST,12, 0,0}},                      // 1 chime
+  {Bell, {E6,4, C6,4, D6,4, G5,8, REST,4, G5,4, D6,4, E6,4, C6,8, REST,12, 0,0}}  // 2 quarters
+};
+#define MELODIES (sizeof(Melody)/sizeof(Melody[0]))
+
+static const melody_t *Playing;   // 0 when quiet
+static uint32_t NoteI;            // index of the current note in notes[]
+static uint32_t NoteLeft;         // samples left in the current note
+static uint32_t Phase, PhaseStep;
+static int32_t Env;               // 0 to ENV_MAX
+uint32_t Speaker_MaxCycles;       // longest sample ISR
+uint32_t Speaker_Overruns;        // samples over SAMPLE_BUDGET
+
+static void NextNote(void){
+  if(Playing->notes[NoteI+1] == 0){
+    NoteI = 0;                    // end, start over
+  }
+  PhaseStep = Step[Playing->notes[NoteI]];
+  NoteLeft = Playing->notes[NoteI+1]*SIXTEENTH;
+  Env = 0;
+  NoteI += 2;
+}
+
+// one sample, called from Timer1A_Handler and by an offline renderer
+uint8_t Speaker_Sample(void){
+  int32_t out;
+  if(NoteLeft == 0){
+    NextNote();
+  }
+  NoteLeft--;
+  if(PhaseStep == 0){
+    return 128;                   // rest
+  }
+  if(NoteLeft + ATTACK > Playing->notes[NoteI-1]*SIXTEENTH){
+    Env += ENV_MAX/ATTACK;        // still in the attack
+  } else{
+    Env -= Env >> 11;
+  }
+  Phase += PhaseStep;
+  out = (Playing->wave[Phase >> 26]*(Env >> 7)) >> 8;   // -127 to 127
+  return (uint8_t)(128 + out);
+}
+
+void Timer1A_Handler(void){
+  uint32_t start = Profile_Start(), cycles;
+  TIMER1_ICR_R = TIMER_ICR_TATOCINT;  // acknowledge timeout
+  PWM1_3_CMPA_R = Speaker_Sample();
+  cycles = Profile_Start() - start;
+  if(cycles > Speaker_MaxCycles) Speaker_MaxCycles = cycles;
+  if(cycles > SAMPLE_BUDGET) Speaker_Overruns++;
+}
+
+// Start melody number m (0 to MELODIES-1) looping on PF2
+void Speaker_Play(uint32_t m){
+  SYSCTL_RCGCPWM_R |= 0x02;       // 1) activate PWM1
+  SYSCTL_RCGCTIMER_R |= 0x02;     //    and Timer1
+  while((SYSCTL_PRPWM_R&0x02) == 0){};    // registers fault until ready
+  while((SYSCTL_PRTIMER_R&0x02) == 0){};
+  TIMER1_CTL_R = 0;               // quiet while the state changes
+  Playing = &Melody[m % MELODIES];
+  NoteI = 0;
+  NoteLeft = 0;
+  SYSCTL_RCC_R &= ~SYSCTL_RCC_USEPWMDIV;  // 2) PWM clock is the bus clock
+  GPIO_PORTF_AFSEL_R |= 0x04;     // 3) PF2 is M1PWM6 while the alarm sounds
+  GPIO_PORTF_PCTL_R = (GPIO_PORTF_PCTL_R&0xFFFFF0FF)|0x00000500;
+  PWM1_3_CTL_R = 0;               // 4) count down from LOAD
+  PWM1_3_GENA_R = 0xC8;           //    low on LOAD, high on CMPA down
+  PWM1_3_LOAD_R = 256 - 1;        // 5) 312.5 kHz carrier
+  PWM1_3_CMPA_R = 128;            //    silence is half duty
+  PWM1_3_CTL_R |= 0x01;           // 6) start the generator
+  PWM1_ENABLE_R |= 0x40;          //    drive M1PWM6
+  TIMER1_CFG_R = 0;               // 7) 32-bit periodic sample clock
+  TIMER1_TAMR_R = TIMER_TAMR_TAMR_PERIOD;
+  TIMER1_TAILR_R = 80000000/SAMPLE_RATE - 1;
+  TIMER1_TAPR_R = 0;
+  TIMER1_ICR_R = TIMER_ICR_TATOCINT;
+  TIMER1_IMR_R = TIMER_IMR_TATOIM;
+  NVIC_PRI5_R = (NVIC_PRI5_R&0xFFFF00FF)|0x0000E000;  // 8) priority 7, lowest
+  NVIC_EN0_R = 1<<21;             // 9) IRQ 21 is Timer1A
+  TIMER1_CTL_R = TIMER_CTL_TAEN;  // 10) go
+}
+
+// Stop the melody and give PF2 back to the LED
+void Speaker_Stop(void){
+  if(Playing == 0) return;
+  if((SYSCTL_PRTIMER_R&0x02) == 0) return;   // never played, Timer1 is off
+  TIMER1_CTL_R = 0;
+  PWM1_ENABLE_R &= ~0x40;
+  GPIO_PORTF_AFSEL_R &= ~0x04;
+  GPIO_PORTF_PCTL_R &= 0xFFFFF0FF;
+  Playing = 0;
+}
@@ -0,0 +1,19 @@
+// -------------------------------------------------------------------
+// File name: Storage.h
+// Description: Word addressed non-volatile store used by the settings log.
+//              The TM4C EEPROM is one implementation; anything that can
+//              read and write 32-bit words (a RAM array on a PC) can stand
+//              in for it.
+//------------------------------------------------------------------------------
+#include <stdint.h>
+
+#ifndef STORAGE_H
+#define STORAGE_H
+typedef struct storage_t {
+  uint32_t words;           // size in 32-bit words
+  // copy n words starting at word addr into data
+  void (*read)(uint32_t addr, uint32_t *data, uint32_t n);
+  // program n words starting at word addr, returns 0 on success
+  int (*write)(uint32_t addr, const uint32_t *data, uint32_t n);
+} storage_t;
+#endif
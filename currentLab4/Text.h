@@ -0,0 +1,24 @@
+// -------------------------------------------------------------------
+// File name: Text.h
+// Description: Strings in the 5x7 font drawn one text line at a time, with
+//              one address window for the text instead of one per character
+//------------------------------------------------------------------------------
+#include <stdint.h>
+
+#define TEXT_MAXCHARS 11    // longest string drawn, longer ones are cut
+
+// 5x7 font, five columns per character code 0 to 254, bit 0 is the top row;
+// the same glyphs as ST7735_DrawString
+extern const uint8_t Text_Font[255*5];
+
+// address windows opened since reset, one per string drawn
+extern uint32_t Text_Windows;
+
+//------------Text_DrawString------------
+// Draw a string in 6 by 8 pixel cells, like ST7735_DrawString, with the
+// background color behind the text. Characters past TEXT_MAXCHARS or past
+// the right edge of the screen are not drawn.
+// Input: x,y top left corner in pixels, pt null-terminated string,
+//        16-bit text and background colors
+// Output: none
+void Text_DrawString(int16_t x, int16_t y, const char *pt, uint16_t color, uint16_t bg);
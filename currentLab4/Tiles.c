@@ -0,0 +1,132 @@
+// -------------------------------------------------------------------
+// File name: Tiles.c
+// Description: Optional 4 bpp palettized frame buffer in front of the
+//              ST7735, see Tiles.h. Only built when DISPLAY_TILES is
+//              defined.
+//------------------------------------------------------------------------------
+#include <stdint.h>
+#include "ST7735.h"
+#define TILES_NO_REDIRECT       // this file talks to the real ST7735
+#include "Tiles.h"
+#include "Arena.h"
+
+#ifdef DISPLAY_TILES
+#define TILES_X  (ST7735_TFTWIDTH/TILE_SIZE)    // 8, one bit each in Dirty
+#define TILES_Y  (ST7735_TFTHEIGHT/TILE_SIZE)   // 10
+
+// two pixels per byte, the even x in the low nibble. All zero, palette
+// entry 0, matches the black screen left by Output_Init.
+static uint8_t Frame[ST7735_TFTHEIGHT][ST7735_TFTWIDTH/2];
+static uint8_t Dirty[TILES_Y];          // bit i is tile column i
+static uint16_t Palette[16] = {ST7735_BLACK};
+static uint32_t PaletteUsed = 1;
+uint32_t Tiles_Sent;
+uint32_t Tiles_PaletteFull;
+
+// palette entry for color, taking a free entry the first time it is seen
+static uint8_t Index(uint16_t color){
+  static uint16_t lastColor = ST7735_BLACK;
+  static uint8_t lastIndex = 0;
+  uint32_t i;
+  if(color == lastColor){
+    return lastIndex;           // bitmaps and fills repeat the same colors
+  }
+  for(i = 0; i < PaletteUsed; i++){
+    if(Palette[i] == color) break;
+  }
+  if(i == PaletteUsed){
+    if(PaletteUsed == 16){
+      Tiles_PaletteFull++;
+      return 0;
+    }
+    Palette[PaletteUsed++] = color;
+  }
+  lastColor = color;
+  lastIndex = i;
+  return i;
+}
+
+static void SetPixel(int x, int y, uint8_t index){
+  uint8_t *pt = &Frame[y][x >> 1];
+  uint8_t value = (x & 1) ? ((*pt & 0x0F) | (index << 4)) : ((*pt & 0xF0) | index);
+  if(value != *pt){
+    *pt = value;
+    Dirty[y/TILE_SIZE] |= 1 << (x/TILE_SIZE);
+  }
+}
+
+void Tiles_DrawPixel(int16_t x, int16_t y, uint16_t color){
+  if((x >= 0) && (x < ST7735_TFTWIDTH) && (y >= 0) && (y < ST7735_TFTHEIGHT)){
+    SetPixel(x, y, Index(color));
+  }
+}
+
+void Tiles_FillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color){
+  uint8_t index = Index(color);
+  int x0 = (x < 0) ? 0 : x, y0 = (y < 0) ? 0 : y;
+  int x1 = (x + w > ST7735_TFTWIDTH) ? ST7735_TFTWIDTH : x + w;
+  int y1 = (y + h > ST7735_TFTHEIGHT) ? ST7735_TFTHEIGHT : y + h;
+  for(int j = y0; j < y1; j++){
+    for(int i = x0; i < x1; i++){
+      SetPixel(i, j, index);
+    }
+  }
+}
+
+void Tiles_DrawBitmap(int16_t x, int16_t y, const uint16_t *image, int16_t w, int16_t h){
+  for(int j = 0; j < h; j++){   // bottom row first
+    for(int i = 0; i < w; i++){
+      Tiles_DrawPixel(x + i, y - j, image[j*w + i]);
+    }
+  }
+}
+
+// Expand pixel rows j0 to j0+rows-1 of tile (tx,ty) through the palette,
+// bottom row first for ST7735_DrawBitmap
+static void Expand(int tx, int ty, int j0, int rows, uint16_t *pt){
+  for(int j = j0 + rows - 1; j >= j0; j--){
+    const uint8_t *row = &Frame[ty*TILE_SIZE + j][tx*TILE_SIZE/2];
+    for(int i = 0; i < TILE_SIZE/2; i++){
+      *pt++ = Palette[row[i] & 0x0F];
+      *pt++ = Palette[row[i] >> 4];
+    }
+  }
+}
+
+uint32_t Tiles_Flush(void){
+  uint32_t left = 0;
+  int ty, tx = -1;
+  for(ty = 0; ty < TILES_Y; ty++){
+    if(Dirty[ty]){
+      for(tx = 0; !(Dirty[ty] & (1 << tx)); tx++){};
+      break;
+    }
+  }
+  if(tx < 0){
+    return 0;                   // nothing changed
+  }
+  Dirty[ty] &= ~(1 << tx);
+  {                             // the tile image takes turns with the text bitmap
+    uint32_t mark = Arena_Mark();
+    uint16_t *image = Arena_Alloc(TILE_SIZE*TILE_SIZE*sizeof(uint16_t));
+    if(image){
+      Expand(tx, ty, 0, TILE_SIZE, image);
+      ST7735_DrawBitmap(tx*TILE_SIZE, ty*TILE_SIZE + TILE_SIZE - 1, image, TILE_SIZE, TILE_SIZE);
+      Arena_Release(mark);
+    } else{                     // no room, one pixel row at a time
+      uint16_t line[TILE_SIZE];
+      for(int j = 0; j < TILE_SIZE; j++){
+        Expand(tx, ty, j, 1, line);
+        ST7735_DrawBitmap(tx*TILE_SIZE, ty*TILE_SIZE + j, line, TILE_SIZE, 1);
+      }
+    }
+  }
+  Tiles_Sent++;
+  for(ty = 0; ty < TILES_Y; ty++){
+    for(uint8_t d = Dirty[ty]; d; d &= d - 1){
+      left++;
+    }
+  }
+  return left;
+}
+#endif
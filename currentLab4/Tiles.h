@@ -0,0 +1,54 @@
+// -------------------------------------------------------------------
+// File name: Tiles.h
+// Description: Optional 4 bpp palettized frame buffer in front of the
+//              ST7735, built when DISPLAY_TILES is defined in the project
+//              options (like DEBUG1). Drawing goes into a 10 KB copy of the
+//              screen split into 16 by 16 pixel tiles. A tile is marked
+//              dirty only when one of its pixels changes color, and only
+//              dirty tiles are sent, expanded through the palette.
+//              Include this after ST7735.h; with DISPLAY_TILES the
+//              ST7735 drawing calls below are sent to the frame buffer.
+//------------------------------------------------------------------------------
+#include <stdint.h>
+
+#ifdef DISPLAY_TILES
+#define TILE_SIZE   16          // pixels on a side
+#define TILE_BYTES  (2*TILE_SIZE*TILE_SIZE)   // RGB565 bytes sent per tile
+
+// tiles sent since reset, and colors drawn after all 16 palette entries
+// were taken (drawn as palette entry 0, black)
+extern uint32_t Tiles_Sent;
+extern uint32_t Tiles_PaletteFull;
+
+//------------Tiles_DrawPixel------------
+// Input: x,y pixel, 16-bit color
+// Output: none
+void Tiles_DrawPixel(int16_t x, int16_t y, uint16_t color);
+
+//------------Tiles_FillRect------------
+// Input: x,y top left corner in pixels, w,h size in pixels, 16-bit color
+// Output: none
+void Tiles_FillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+
+//------------Tiles_DrawBitmap------------
+// Same arguments as ST7735_DrawBitmap
+// Input: x,y lower left corner in pixels, image RGB565 pixels with the
+//        bottom row first, w,h size in pixels
+// Output: none
+void Tiles_DrawBitmap(int16_t x, int16_t y, const uint16_t *image, int16_t w, int16_t h);
+
+//------------Tiles_Flush------------
+// Send the next dirty tile to the ST7735 with one ST7735_DrawBitmap
+// Input: none
+// Output: number of tiles still dirty
+uint32_t Tiles_Flush(void);
+
+#ifndef TILES_NO_REDIRECT
+#define ST7735_DrawPixel(x,y,c)         Tiles_DrawPixel(x,y,c)
+#define ST7735_FillRect(x,y,w,h,c)      Tiles_FillRect(x,y,w,h,c)
+#define ST7735_FillScreen(c)            Tiles_FillRect(0,0,ST7735_TFTWIDTH,ST7735_TFTHEIGHT,c)
+#define ST7735_DrawFastHLine(x,y,w,c)   Tiles_FillRect(x,y,w,1,c)
+#define ST7735_DrawFastVLine(x,y,h,c)   Tiles_FillRect(x,y,1,h,c)
+#define ST7735_DrawBitmap(x,y,i,w,h)    Tiles_DrawBitmap(x,y,i,w,h)
+#endif
+#endif
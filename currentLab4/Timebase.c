@@ -0,0 +1,43 @@
+// -------------------------------------------------------------------
+// File name: Timebase.c
+// Description: Free-running 64-bit monotonic tick counter on wide timer 0,
+//              counting bus clock cycles (12.5 ns at 80 MHz). It never
+//              wraps in practice (7000 years) and needs no interrupt.
+//------------------------------------------------------------------------------
+#include <stdint.h>
+#include "tm4c123gh6pm.h"
+#include "Timebase.h"
+
+void Timebase_Init(void){
+  SYSCTL_RCGCWTIMER_R |= SYSCTL_RCGCWTIMER_R0;   // 0) activate WTIMER0
+  while((SYSCTL_PRWTIMER_R&SYSCTL_PRWTIMER_R0) == 0){};  // wait until ready
+  WTIMER0_CTL_R = 0;                  // 1) disable during setup
+  WTIMER0_CFG_R = 0;                  // 2) 64-bit mode, A and B concatenated
+  WTIMER0_TAMR_R = TIMER_TAMR_TAMR_PERIOD|TIMER_TAMR_TACDIR;  // 3) periodic, count up
+  WTIMER0_TAILR_R = 0xFFFFFFFF;       // 4) full 64-bit range
+  WTIMER0_TBILR_R = 0xFFFFFFFF;
+  WTIMER0_TAV_R = 0;                  // 5) start from 0
+  WTIMER0_TBV_R = 0;
+  WTIMER0_CTL_R = TIMER_CTL_TAEN;     // 6) enable, no interrupts
+}
+
+uint64_t Timebase_Now(void){
+  uint32_t hi, lo;
+// the halves are separate registers; if the high word moved while the low
+// word was read, the low word wrapped in between, so read again
+  do{
+    hi = WTIMER0_TBV_R;
+    lo = WTIMER0_TAV_R;
+  }while(hi != WTIMER0_TBV_R);
+  return ((uint64_t)hi << 32) | lo;
+}
+
+void Timebase_Read(uint32_t *sec, uint32_t *sub){
+  uint64_t now = Timebase_Now();
+  *sec = (uint32_t)(now/TIMEBASE_HZ);
+  *sub = (uint32_t)(now%TIMEBASE_HZ);
+}
+
+uint32_t Timebase_Ms(uint64_t ticks){
+  return (uint32_t)(ticks/(TIMEBASE_HZ/1000));
+}
@@ -0,0 +1,34 @@
+// -------------------------------------------------------------------
+// File name: Timebase.h
+// Description: Free-running 64-bit monotonic tick counter on wide timer 0,
+//              counting bus clock cycles (12.5 ns at 80 MHz). It never
+//              wraps in practice (7000 years) and needs no interrupt.
+//------------------------------------------------------------------------------
+#include <stdint.h>
+
+#define TIMEBASE_HZ  80000000   // ticks per second, the bus clock
+
+//------------Timebase_Init------------
+// Start wide timer 0 as a 64-bit up counter from 0, call after PLL_Init
+// Input: none
+// Output: none
+void Timebase_Init(void);
+
+//------------Timebase_Now------------
+// Read the 64-bit counter, safe from main and interrupts
+// Input: none
+// Output: ticks since Timebase_Init
+uint64_t Timebase_Now(void);
+
+//------------Timebase_Read------------
+// Split one reading of the counter into seconds and sub-second ticks
+// Input: pointers to fill in
+// Output: *sec whole seconds, *sub ticks into the current second (0 to
+//         TIMEBASE_HZ-1); both come from the same reading
+void Timebase_Read(uint32_t *sec, uint32_t *sub);
+
+//------------Timebase_Ms------------
+// Convert a tick interval to milliseconds
+// Input: ticks, an interval from Timebase_Now differences
+// Output: milliseconds, truncated
+uint32_t Timebase_Ms(uint64_t ticks);
@@ -0,0 +1,54 @@
+// -------------------------------------------------------------------
+// File name: Eeprom.c
+// Description: Host stand-in for the TM4C123 EEPROM, a RAM file of the
+//              same 512 words. Reads and writes spend the module's time
+//              on the simulated CPU, as Eeprom.c polls EEDONE on the board.
+//------------------------------------------------------------------------------
+#include <stdint.h>
+#include "Sim.h"
+#include "Eeprom.h"
+
+uint32_t Eeprom_WordsRead;
+uint32_t Eeprom_WordsWritten;
+int32_t Eeprom_Tear = -1;
+
+static uint32_t Words[EEPROM_WORDS];
+static int Formatted;
+
+static void Read(uint32_t addr, uint32_t *data, uint32_t n){
+  for(uint32_t i = 0; i < n; i++){
+    data[i] = Words[(addr + i)%EEPROM_WORDS];
+  }
+  Eeprom_WordsRead += n;
+  Sim_Spend((uint64_t)n*EEPROM_READ_CYCLES);
+}
+
+static int Write(uint32_t addr, const uint32_t *data, uint32_t n){
+  int torn = (Eeprom_Tear >= 0) && ((uint32_t)Eeprom_Tear < n);
+  if(torn){
+    n = (uint32_t)Eeprom_Tear;
+  }
+  Eeprom_Tear = -1;
+  for(uint32_t i = 0; i < n; i++){
+    Words[(addr + i)%EEPROM_WORDS] = data[i];
+  }
+  Eeprom_WordsWritten += n;
+  Sim_Spend((uint64_t)n*EEPROM_WRITE_CYCLES);
+  return torn ? -1 : 0;
+}
+
+const storage_t Eeprom_Storage = {EEPROM_WORDS, &Read, &Write};
+
+void Eeprom_Erase(void){
+  for(int i = 0; i < EEPROM_WORDS; i++){
+    Words[i] = 0xFFFFFFFF;
+  }
+  Formatted = 1;
+}
+
+int Eeprom_Init(void){
+  if(!Formatted){
+    Eeprom_Erase();
+  }
+  return 0;
+}
@@ -0,0 +1,39 @@
+// -------------------------------------------------------------------
+// File name: Eeprom.h
+// Description: Host stand-in for the TM4C123 EEPROM: a RAM file of the
+//              same 512 words behind the same storage_t. It keeps its
+//              contents across Sim_Init, as the chip keeps them across
+//              resets, counts the words read and written, charges the
+//              module's word times to virtual time and can cut a write
+//              short as a reset in the middle of it would.
+//------------------------------------------------------------------------------
+#include <stdint.h>
+#include "Storage.h"
+
+#ifndef EEPROM_H
+#define EEPROM_H
+#define EEPROM_WORDS        512
+#define EEPROM_READ_CYCLES  4       // about 4 bus cycles a word read
+#define EEPROM_WRITE_CYCLES 8800    // about 110 us a word programmed
+
+extern const storage_t Eeprom_Storage;
+
+// words read and programmed since power-up
+extern uint32_t Eeprom_WordsRead;
+extern uint32_t Eeprom_WordsWritten;
+
+// the next write programs only this many words and fails, -1 for none
+extern int32_t Eeprom_Tear;
+
+//------------Eeprom_Init------------
+// Power up the EEPROM module; erases the RAM file the first time
+// Input: none
+// Output: 0, the stand-in is always ready
+int Eeprom_Init(void);
+
+//------------Eeprom_Erase------------
+// Set every word to 0xFFFFFFFF, as a new part comes
+// Input: none
+// Output: none
+void Eeprom_Erase(void);
+#endif
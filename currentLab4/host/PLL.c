@@ -0,0 +1,10 @@
+// -------------------------------------------------------------------
+// File name: PLL.c
+// Description: Host stand-in for Valvano's PLL driver, see PLL.h
+//------------------------------------------------------------------------------
+#include <stdint.h>
+#include "PLL.h"
+
+void PLL_Init(uint32_t freq){
+  (void)freq;                   // the simulation always runs at 80 MHz
+}
@@ -0,0 +1,13 @@
+// -------------------------------------------------------------------
+// File name: PLL.h
+// Description: Host stand-in for Valvano's PLL driver. The simulation
+//              always runs the bus at 80 MHz (SIM_HZ).
+//------------------------------------------------------------------------------
+#include <stdint.h>
+
+#define Bus80MHz     4
+
+//------------PLL_Init------------
+// Input: freq one of the BusxxMHz constants, ignored
+// Output: none
+void PLL_Init(uint32_t freq);
@@ -0,0 +1,16 @@
+// -------------------------------------------------------------------
+// File name: PortF.c
+// Description: Host stand-in for Valvano's PortF driver, see PortF.h
+//------------------------------------------------------------------------------
+#include <stdint.h>
+#include "PortF.h"
+
+uint32_t PortF_Data;
+
+void PortF_Init(void){
+  PortF_Data = 0;
+}
+
+void PortF_Output(uint32_t data){
+  PortF_Data = data;
+}
@@ -0,0 +1,19 @@
+// -------------------------------------------------------------------
+// File name: PortF.h
+// Description: Host stand-in for Valvano's PortF driver. The LEDs on
+//              PF3-PF1 are kept in a variable tests can read.
+//------------------------------------------------------------------------------
+#include <stdint.h>
+
+// host only: last value written with PortF_Output
+extern uint32_t PortF_Data;
+
+//------------PortF_Init------------
+// Input: none
+// Output: none
+void PortF_Init(void);
+
+//------------PortF_Output------------
+// Input: data, bits 3-1 drive the green, blue and red LEDs
+// Output: none
+void PortF_Output(uint32_t data);
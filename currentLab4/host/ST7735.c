@@ -0,0 +1,145 @@
+// -------------------------------------------------------------------
+// File name: ST7735.c
+// Description: Host stand-in for Valvano's ST7735 driver, see ST7735.h.
+//              Each call costs what the driver sends: an address window
+//              (CASET, RASET and RAMWR with their parameters, 11 bytes)
+//              and two bytes per pixel, all blocking on SSI0. Pixels off
+//              the screen are clipped and not counted.
+//------------------------------------------------------------------------------
+#include <stdint.h>
+#include "Sim.h"
+#include "ST7735.h"
+#include "Text.h"
+
+#define WINDOW_BYTES 11
+
+uint16_t ST7735_Frame[ST7735_TFTHEIGHT][ST7735_TFTWIDTH];
+uint32_t ST7735_Bytes;
+uint32_t ST7735_Windows;
+static uint16_t TextColor = ST7735_YELLOW;
+static uint32_t StX, StY;       // cursor of the text terminal
+
+static int Plot(int x, int y, uint16_t color){
+  if((x < 0) || (x >= ST7735_TFTWIDTH) || (y < 0) || (y >= ST7735_TFTHEIGHT)){
+    return 0;
+  }
+  ST7735_Frame[y][x] = color;
+  return 1;
+}
+
+// one address window and the pixels sent in it
+static void Send(uint32_t pixels){
+  uint32_t bytes = WINDOW_BYTES + 2*pixels;
+  ST7735_Windows++;
+  ST7735_Bytes += bytes;
+  Sim_Spend((uint64_t)bytes*SIM_SPI_BYTE);
+}
+
+void Output_Init(void){
+  StX = StY = 0;
+  ST7735_FillScreen(ST7735_BLACK);
+}
+
+void Output_Color(uint32_t newColor){
+  TextColor = newColor;
+}
+
+void ST7735_DrawPixel(int16_t x, int16_t y, uint16_t color){
+  if(Plot(x, y, color)){
+    Send(1);
+  }
+}
+
+void ST7735_FillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color){
+  uint32_t n = 0;
+  if((x >= ST7735_TFTWIDTH) || (y >= ST7735_TFTHEIGHT)) return;
+  for(int j = y; j < y + h; j++){
+    for(int i = x; i < x + w; i++){
+      n += Plot(i, j, color);
+    }
+  }
+  if(n){
+    Send(n);
+  }
+}
+
+void ST7735_DrawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color){
+  ST7735_FillRect(x, y, 1, h, color);
+}
+
+void ST7735_DrawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color){
+  ST7735_FillRect(x, y, w, 1, color);
+}
+
+void ST7735_FillScreen(uint16_t color){
+  ST7735_FillRect(0, 0, ST7735_TFTWIDTH, ST7735_TFTHEIGHT, color);
+}
+
+// (x,y) is the lower left corner, image holds the bottom row first
+void ST7735_DrawBitmap(int16_t x, int16_t y, const uint16_t *image, int16_t w, int16_t h){
+  uint32_t n = 0;
+  if((w > ST7735_TFTWIDTH) || (h > ST7735_TFTHEIGHT)) return;   // does not fit
+  for(int j = 0; j < h; j++){
+    for(int i = 0; i < w; i++){
+      n += Plot(x + i, y - j, image[j*w + i]);
+    }
+  }
+  if(n){
+    Send(n);
+  }
+}
+
+// one window for the whole 6*size by 8*size cell, top row first
+void ST7735_DrawChar(int16_t x, int16_t y, char c, int16_t textColor, int16_t bgColor, uint8_t size){
+  uint32_t n = 0;
+  for(int row = 0; row < 8*size; row++){
+    for(int col = 0; col < 6*size; col++){
+      uint8_t bits = (col/size < 5) ? Text_Font[(uint8_t)c*5 + col/size] : 0;
+      n += Plot(x + col, y + row, (bits & (1 << (row/size))) ? textColor : bgColor);
+    }
+  }
+  if(n){
+    Send(n);
+  }
+}
+
+uint32_t ST7735_DrawString(uint16_t x, uint16_t y, char *pt, int16_t textColor){
+  uint32_t count = 0;
+  if(y > 15) return 0;
+  while(*pt && (x < 21)){
+    ST7735_DrawChar(x*6, y*10, *pt, textColor, ST7735_BLACK, 1);
+    pt++;
+    x++;
+    count++;
+  }
+  return count;
+}
+
+void ST7735_SetCursor(uint32_t newX, uint32_t newY){
+  if((newX > 20) || (newY > 15)) return;
+  StX = newX;
+  StY = newY;
+}
+
+void ST7735_OutChar(char ch){
+  if((ch == '\n') || (ch == '\r') || (StX > 20)){
+    StX = 0;
+    StY = (StY + 1)%16;
+    if((ch == '\n') || (ch == '\r')) return;
+  }
+  ST7735_DrawChar(StX*6, StY*10, ch, TextColor, ST7735_BLACK, 1);
+  StX++;
+}
+
+void ST7735_OutString(char *ptr){
+  while(*ptr){
+    ST7735_OutChar(*ptr++);
+  }
+}
+
+void ST7735_OutUDec(uint32_t n){
+  if(n >= 10){
+    ST7735_OutUDec(n/10);
+  }
+  ST7735_OutChar('0' + n%10);
+}
@@ -0,0 +1,45 @@
+// -------------------------------------------------------------------
+// File name: ST7735.h
+// Description: Host stand-in for Valvano's ST7735 driver, the calls the
+//              sources in this directory make. Drawing goes into a frame
+//              buffer that tests can read, and every call counts the SPI
+//              bytes the real driver would send and spends the time they
+//              take on SSI0.
+//------------------------------------------------------------------------------
+#include <stdint.h>
+
+#ifndef ST7735_H
+#define ST7735_H
+#define ST7735_TFTWIDTH  128
+#define ST7735_TFTHEIGHT 160
+
+// colors of the red tab panel, which is wired BGR
+#define ST7735_BLACK   0x0000
+#define ST7735_BLUE    0xF800
+#define ST7735_RED     0x001F
+#define ST7735_GREEN   0x07E0
+#define ST7735_CYAN    0xFFE0
+#define ST7735_MAGENTA 0xF81F
+#define ST7735_YELLOW  0x07FF
+#define ST7735_WHITE   0xFFFF
+
+// host only: the screen, and the bytes and address windows sent to it
+extern uint16_t ST7735_Frame[ST7735_TFTHEIGHT][ST7735_TFTWIDTH];
+extern uint32_t ST7735_Bytes;
+extern uint32_t ST7735_Windows;
+
+void Output_Init(void);
+void Output_Color(uint32_t newColor);
+void ST7735_DrawPixel(int16_t x, int16_t y, uint16_t color);
+void ST7735_DrawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
+void ST7735_DrawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+void ST7735_FillScreen(uint16_t color);
+void ST7735_FillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+void ST7735_DrawBitmap(int16_t x, int16_t y, const uint16_t *image, int16_t w, int16_t h);
+void ST7735_DrawChar(int16_t x, int16_t y, char c, int16_t textColor, int16_t bgColor, uint8_t size);
+uint32_t ST7735_DrawString(uint16_t x, uint16_t y, char *pt, int16_t textColor);
+void ST7735_SetCursor(uint32_t newX, uint32_t newY);
+void ST7735_OutChar(char ch);
+void ST7735_OutString(char *ptr);
+void ST7735_OutUDec(uint32_t n);
+#endif
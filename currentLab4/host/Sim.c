@@ -0,0 +1,354 @@
+// -------------------------------------------------------------------
+// File name: Sim.c
+// Description: Virtual time for the host build, see Sim.h. Also stands in
+//              for the interrupt routines of startup.s and models the two
+//              peripherals the firmware drives through registers alone:
+//              uDMA channel 11 feeding SSI0, and Timer1A for the speaker.
+//------------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <ucontext.h>
+#include "tm4c123gh6pm.h"
+#include "Sim.h"
+
+#define PERIPHERALS   0x40000000  // GPIO to uDMA, 1 MB
+#define PRIVATE       0xE0000000  // DWT, SysTick, NVIC, 1 MB
+#define MAPSIZE       0x00100000
+#define TIMERS        16
+#define WATCHERS      4
+#define STACKSIZE     (1 << 20)
+#define CH_SSI0TX     11
+#define DWT_CYCCNT_R  (*((volatile uint32_t *)0xE0001004))   // as in Profile.c
+
+// handlers of the firmware modules that may not be linked into a test
+void SSI0_Handler(void) __attribute__((weak));      // Fill.c
+void Timer1A_Handler(void) __attribute__((weak));   // Speaker.c
+
+typedef struct sim_timer_t {
+  uint64_t at;                  // cycle it is due
+  uint64_t period;              // 0 for once
+  void (*isr)(void);            // interrupt, held off by the I bit
+  void (*fn)(uint32_t arg);     // hardware event, runs when due
+  uint32_t arg;
+  int active;
+} sim_timer_t;
+
+uint64_t Sim_Now;
+uint64_t Sim_BlockedCycles;
+uint64_t Sim_DmaCycles;
+static sim_timer_t Timer[TIMERS];
+static void (*Watcher[WATCHERS])(void);
+static int Mapped;
+static int Masked;              // I bit, clear out of reset
+static uint64_t MaskedFrom;     // cycle the I bit was set
+uint64_t Sim_MaskedMax;
+static int InIsr;               // one handler at a time, none preempts another
+static uint64_t Until;
+static ucontext_t HostContext, FirmwareContext;
+static int (*FirmwareMain)(void);
+static int Booted, Running;
+static int DmaActive;
+static uint64_t DmaLength;
+static int Timer1Running;
+
+static void Registers(void){
+  if(Mapped){
+    WTIMER0_TAV_R = (uint32_t)Sim_Now;
+    WTIMER0_TBV_R = (uint32_t)(Sim_Now >> 32);
+    DWT_CYCCNT_R = (uint32_t)Sim_Now;
+  }
+}
+
+static sim_timer_t *NewTimer(void){
+  for(int i = 0; i < TIMERS; i++){
+    if(!Timer[i].active){
+      return &Timer[i];
+    }
+  }
+  fprintf(stderr, "Sim: more than %d timers\n", TIMERS);
+  exit(1);
+}
+
+void Sim_Cancel(void (*isr)(void)){
+  for(int i = 0; i < TIMERS; i++){
+    if(Timer[i].active && (Timer[i].isr == isr)){
+      Timer[i].active = 0;
+    }
+  }
+}
+
+void Sim_Every(uint64_t period, void (*isr)(void)){
+  sim_timer_t *t;
+  Sim_Cancel(isr);
+  t = NewTimer();
+  t->at = Sim_Now + period;
+  t->period = period;
+  t->isr = isr;
+  t->fn = 0;
+  t->active = 1;
+}
+
+void Sim_After(uint64_t delay, void (*isr)(void)){
+  sim_timer_t *t;
+  Sim_Cancel(isr);
+  t = NewTimer();
+  t->at = Sim_Now + delay;
+  t->period = 0;
+  t->isr = isr;
+  t->fn = 0;
+  t->active = 1;
+}
+
+void Sim_At(uint64_t at, void (*fn)(uint32_t arg), uint32_t arg){
+  sim_timer_t *t = NewTimer();
+  t->at = (at > Sim_Now) ? at : Sim_Now;
+  t->period = 0;
+  t->isr = 0;
+  t->fn = fn;
+  t->arg = arg;
+  t->active = 1;
+}
+
+void Sim_Watch(void (*fn)(void)){
+  for(int i = 0; i < WATCHERS; i++){
+    if((Watcher[i] == 0) || (Watcher[i] == fn)){
+      Watcher[i] = fn;
+      return;
+    }
+  }
+  fprintf(stderr, "Sim: more than %d watchers\n", WATCHERS);
+  exit(1);
+}
+
+//------------------------------- uDMA and SSI0 --------------------------------
+// A transfer starts once channel 11 is enabled and SSI0 requests it; its
+// length comes from the channel control word in the firmware's table. It
+// takes two SPI bytes a pixel, then completion is signaled on SSI0.
+static void DmaDone(void){
+  DmaActive = 0;
+  Sim_DmaCycles += DmaLength;
+  UDMA_ENASET_R &= ~(1u << CH_SSI0TX);
+  UDMA_CHIS_R = 1u << CH_SSI0TX;
+  SSI0_Handler();
+}
+
+static void DmaPoll(void){
+  volatile uint32_t *table;
+  uint32_t n;
+  if(DmaActive || (SSI0_Handler == 0) ||
+     !(SSI0_DMACTL_R & SSI_DMACTL_TXDMAE) || !(UDMA_ENASET_R & (1u << CH_SSI0TX))){
+    return;
+  }
+  // the firmware stores the table address as 32 bits, the host build is
+  // linked without PIE so it fits
+  table = (volatile uint32_t *)(uintptr_t)UDMA_CTLBASE_R;
+  n = ((table[4*CH_SSI0TX + 2] >> 4) & 0x3FF) + 1;
+  DmaActive = 1;
+  DmaLength = (uint64_t)n*2*SIM_SPI_BYTE;
+  Sim_After(DmaLength, &DmaDone);
+}
+
+// Timer1A interrupts while it is enabled, at the period in TAILR
+static void Timer1Poll(void){
+  int on = (Timer1A_Handler != 0) && (TIMER1_CTL_R & TIMER_CTL_TAEN);
+  if(on && !Timer1Running){
+    Sim_Every(TIMER1_TAILR_R + 1, Timer1A_Handler);
+  }
+  if(!on && Timer1Running){
+    Sim_Cancel(Timer1A_Handler);
+  }
+  Timer1Running = on;
+}
+
+static void Poll(void){
+  if(!Mapped) return;
+  DmaPoll();
+  Timer1Poll();
+  for(int i = 0; (i < WATCHERS) && Watcher[i]; i++){
+    Watcher[i]();
+  }
+}
+
+//------------------------------- time -----------------------------------------
+// earliest timer due by cycle to that may run now
+static sim_timer_t *Next(uint64_t to){
+  sim_timer_t *best = 0;
+  for(int i = 0; i < TIMERS; i++){
+    sim_timer_t *t = &Timer[i];
+    if(!t->active || (t->at > to)) continue;
+    if(t->isr && (Masked || InIsr)) continue;
+    if((best == 0) || (t->at < best->at)){
+      best = t;
+    }
+  }
+  return best;
+}
+
+static void Fire(sim_timer_t *t){
+  if(t->period){
+    do{                         // one pending bit, missed periods are lost
+      t->at += t->period;
+    }while(t->at <= Sim_Now);
+  } else{
+    t->active = 0;
+  }
+  if(t->isr){
+    InIsr = 1;
+    t->isr();
+    InIsr = 0;
+  } else{
+    t->fn(t->arg);
+  }
+}
+
+// move time to cycle to, running whatever comes due in order
+static void Advance(uint64_t to){
+  sim_timer_t *t;
+  Poll();
+  while((t = Next(to)) != 0){
+    if(t->at > Sim_Now){
+      Sim_Now = t->at;
+      Registers();
+    }
+    Fire(t);
+    Poll();
+  }
+  if(to > Sim_Now){
+    Sim_Now = to;
+    Registers();
+  }
+}
+
+void Sim_Spend(uint64_t cycles){
+  Sim_BlockedCycles += cycles;
+  Advance(Sim_Now + cycles);
+}
+
+void Sim_Init(void){
+  if(!Mapped){
+    if((mmap((void *)PERIPHERALS, MAPSIZE, PROT_READ|PROT_WRITE,
+             MAP_PRIVATE|MAP_ANONYMOUS|MAP_FIXED_NOREPLACE, -1, 0) != (void *)PERIPHERALS) ||
+       (mmap((void *)PRIVATE, MAPSIZE, PROT_READ|PROT_WRITE,
+             MAP_PRIVATE|MAP_ANONYMOUS|MAP_FIXED_NOREPLACE, -1, 0) != (void *)PRIVATE)){
+      perror("Sim: cannot map the peripheral registers");
+      exit(1);
+    }
+    Mapped = 1;
+  }
+  memset((void *)PERIPHERALS, 0, MAPSIZE);
+  memset((void *)PRIVATE, 0, MAPSIZE);
+  memset(Timer, 0, sizeof(Timer));
+  memset(Watcher, 0, sizeof(Watcher));
+  SYSCTL_PRTIMER_R = SYSCTL_PRGPIO_R = SYSCTL_PRDMA_R = 0xFFFFFFFF;  // every
+  SYSCTL_PRPWM_R = SYSCTL_PREEPROM_R = SYSCTL_PRWTIMER_R = 0xFFFFFFFF; // module ready
+  SSI0_SR_R = SSI_SR_TNF|SSI_SR_TFE;  // never busy, the pixels are counted elsewhere
+  Sim_Now = Sim_BlockedCycles = Sim_DmaCycles = Sim_MaskedMax = 0;
+  Masked = InIsr = 0;
+  DmaActive = Timer1Running = 0;
+  Registers();
+}
+
+//------------------------------- firmware -------------------------------------
+static void Yield(void){
+  Running = 0;
+  swapcontext(&FirmwareContext, &HostContext);
+}
+
+static void Start(void){
+  FirmwareMain();
+  fprintf(stderr, "Sim: firmware main returned\n");
+  exit(1);
+}
+
+void Sim_Boot(int (*main)(void)){
+  static char *stack;
+  if(stack == 0){
+    stack = malloc(STACKSIZE);
+  }
+  getcontext(&FirmwareContext);
+  FirmwareContext.uc_stack.ss_sp = stack;
+  FirmwareContext.uc_stack.ss_size = STACKSIZE;
+  FirmwareContext.uc_link = 0;
+  makecontext(&FirmwareContext, &Start, 0);
+  FirmwareMain = main;
+  Booted = 1;
+}
+
+void Sim_Run(uint64_t until){
+  Until = until;
+  if(!Booted){
+    Advance(until);             // no firmware, only the interrupts
+    return;
+  }
+  Running = 1;
+  swapcontext(&HostContext, &FirmwareContext);
+}
+
+uint64_t Sim_HostNs(void){
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return (uint64_t)t.tv_sec*1000000000 + t.tv_nsec;
+}
+
+//------------------------------- startup.s ------------------------------------
+// the window the I bit has been set for ends now
+static void Unmasked(void){
+  if(Masked && (Sim_Now - MaskedFrom > Sim_MaskedMax)){
+    Sim_MaskedMax = Sim_Now - MaskedFrom;
+  }
+}
+
+// sets the I bit and times how long it stays set
+static void Mask(int masked){
+  if(!masked){
+    Unmasked();
+  } else if(!Masked){
+    MaskedFrom = Sim_Now;
+  }
+  Masked = masked;
+}
+
+void DisableInterrupts(void){
+  Mask(1);
+}
+
+void EnableInterrupts(void){
+  Mask(0);
+  Advance(Sim_Now);             // handlers that came due while masked
+}
+
+long StartCritical(void){
+  long sr = Masked;
+  Mask(1);
+  return sr;
+}
+
+void EndCritical(long sr){
+  Mask(sr);
+  if(!Masked){
+    Advance(Sim_Now);
+  }
+}
+
+// Sleep until an interrupt is pending; a masked one wakes the CPU without
+// running, as on the board
+void WaitForInterrupt(void){
+  uint64_t wake = Until;
+  Unmasked();                   // asleep, a pending interrupt wakes it at once
+  if(Running && (Sim_Now >= Until)){
+    Yield();                    // Sim_Run is over, continue from here next time
+    wake = Until;
+  }
+  Poll();
+  for(int i = 0; i < TIMERS; i++){
+    if(Timer[i].active && Timer[i].isr && (Timer[i].at < wake)){
+      wake = Timer[i].at;
+    }
+  }
+  Advance(wake);
+  MaskedFrom = Sim_Now;
+}
@@ -0,0 +1,104 @@
+// -------------------------------------------------------------------
+// File name: Sim.h
+// Description: Virtual time for the host build. The TM4C123 peripheral
+//              address ranges are mapped as ordinary memory, so the
+//              register macros of tm4c123gh6pm.h work unchanged, and the
+//              interrupts the firmware relies on (SysTick, Timer1A,
+//              Timer2A, Timer3A, SSI0 uDMA completion) are scheduled on a
+//              bus cycle clock. Time moves when the firmware sleeps in
+//              WaitForInterrupt and when a stand-in spends CPU time on a
+//              blocking transfer, such as an ST7735 call. Interrupts only
+//              run while the I bit is clear, as on the board.
+//------------------------------------------------------------------------------
+#include <stdint.h>
+
+#ifndef SIM_H
+#define SIM_H
+#define SIM_HZ        80000000  // bus clock, cycles per second
+#define SIM_SPI_BYTE  80        // cycles per byte to the ST7735, 8 MHz SSI0
+#define SIM_UART_BYTE 6944      // cycles per byte to the ESP8266, 115200 baud
+
+// bus cycles since Sim_Init
+extern uint64_t Sim_Now;
+
+// cycles the CPU spent blocked in stand-in transfers, and cycles uDMA kept
+// SSI0 busy while the CPU was free
+extern uint64_t Sim_BlockedCycles;
+extern uint64_t Sim_DmaCycles;
+
+// longest stretch of cycles the I bit was set, a test may clear it
+extern uint64_t Sim_MaskedMax;
+
+//------------Sim_Init------------
+// Map the peripheral address ranges, clear the registers and set the ones
+// the firmware polls to their ready values; stops all interrupts
+// Input: none
+// Output: none
+void Sim_Init(void);
+
+//------------Sim_Every------------
+// Run an interrupt handler every period cycles, the first one period
+// cycles from now; replaces an earlier entry for the same handler
+// Input: period in cycles, isr handler
+// Output: none
+void Sim_Every(uint64_t period, void (*isr)(void));
+
+//------------Sim_Cancel------------
+// Stop the interrupt started with Sim_Every or Sim_After
+// Input: isr handler
+// Output: none
+void Sim_Cancel(void (*isr)(void));
+
+//------------Sim_After------------
+// Run an interrupt handler once, delay cycles from now
+// Input: delay in cycles, isr handler
+// Output: none
+void Sim_After(uint64_t delay, void (*isr)(void));
+
+//------------Sim_At------------
+// Run a hardware event (not an interrupt, so the I bit does not hold it
+// off) at a point in virtual time, such as a message reaching the ESP8266
+// Input: at in cycles since Sim_Init, fn called with the event's arg
+// Output: none
+void Sim_At(uint64_t at, void (*fn)(uint32_t arg), uint32_t arg);
+
+//------------Sim_Watch------------
+// Call fn every time the simulation gets control, so a stand-in can react
+// to register writes (at most 4 watchers)
+// Input: fn watcher
+// Output: none
+void Sim_Watch(void (*fn)(void));
+
+//------------Sim_Spend------------
+// The CPU is busy for cycles, interrupts that come due meanwhile run if
+// the I bit is clear
+// Input: cycles
+// Output: none
+void Sim_Spend(uint64_t cycles);
+
+//------------Sim_Boot------------
+// Give the firmware its own stack and enter main on the next Sim_Run
+// Input: main firmware entry
+// Output: none
+void Sim_Boot(int (*main)(void));
+
+//------------Sim_Run------------
+// Run the firmware until virtual time reaches until. It is stopped the
+// first time it sleeps after that and continues from there on the next
+// Sim_Run, so the caller can inject input and read counters in between.
+// Input: until in cycles since Sim_Init
+// Output: none
+void Sim_Run(uint64_t until);
+
+//------------Sim_HostNs------------
+// Wall clock of the PC, for timing code that runs on it; tests that see
+// the firmware's int time cannot include <time.h> themselves
+// Input: none
+// Output: nanoseconds from an arbitrary start
+uint64_t Sim_HostNs(void);
+
+//------------Sim_Ms------------
+// Input: cycles
+// Output: milliseconds
+#define Sim_Ms(cycles) ((cycles)/(SIM_HZ/1000))
+#endif
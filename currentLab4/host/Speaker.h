@@ -0,0 +1,17 @@
+// -------------------------------------------------------------------
+// File name: Speaker.h
+// Description: Host stand-in for the header of Speaker.c: the alarm and
+//              synthesizer entry points
+//------------------------------------------------------------------------------
+#include <stdint.h>
+
+#ifndef SPEAKER_H
+#define SPEAKER_H
+extern int time_alarm, alarm, inAlarm;
+
+void setAlarm(int t);
+int checkAlarm(int t);
+uint8_t Speaker_Sample(void);
+void Speaker_Play(uint32_t m);
+void Speaker_Stop(void);
+#endif
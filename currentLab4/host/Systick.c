@@ -0,0 +1,26 @@
+// -------------------------------------------------------------------
+// File name: Systick.c
+// Description: Host stand-in for the lab's SysTick driver, see Systick.h
+//------------------------------------------------------------------------------
+#include <stdint.h>
+#include "Sim.h"
+#include "Systick.h"
+
+#define RELOAD 800000           // 10 ms at 80 MHz, as NVIC_ST_RELOAD_R
+
+int secFlag;
+uint32_t SysTick_Period = RELOAD;
+static int Count;
+
+void SysTick_Handler(void){
+  Count++;
+  if(Count == 100){
+    Count = 0;
+    secFlag = 1;
+  }
+}
+
+void SysTick_Init(void){
+  Count = 0;
+  Sim_Every(SysTick_Period, &SysTick_Handler);
+}
@@ -0,0 +1,19 @@
+// -------------------------------------------------------------------
+// File name: Systick.h
+// Description: Host stand-in for the lab's SysTick driver: a 10 ms
+//              interrupt that sets secFlag every 100th time
+//------------------------------------------------------------------------------
+#include <stdint.h>
+
+// set once a second by SysTick_Handler, cleared by the main loop
+extern int secFlag;
+
+// host only: cycles between interrupts, 10 ms of the bus clock unless a
+// test sets it before SysTick_Init to model SysTick on another clock source
+extern uint32_t SysTick_Period;
+
+//------------SysTick_Init------------
+// Start the 10 ms SysTick interrupt
+// Input: none
+// Output: none
+void SysTick_Init(void);
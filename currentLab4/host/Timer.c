@@ -0,0 +1,39 @@
+// -------------------------------------------------------------------
+// File name: Timer.c
+// Description: Host stand-in for the lab's Timer.c, see Timer.h
+//------------------------------------------------------------------------------
+#include <stdint.h>
+#include "Timer.h"
+
+int time = (8*3600 + 46*60) - 25;   // Factory_Time in Blynk.c
+char sec[3] = "00", min[3] = "00", hour[3] = "12";
+uint32_t h, m, s;
+
+int updateTime(int flag, int t){
+  if(flag){
+    return (t + 1)%43200;
+  }
+  return t;
+}
+
+static void TwoDigits(uint32_t n, char *pt){
+  pt[0] = '0' + n/10;
+  pt[1] = '0' + n%10;
+}
+
+void getSeconds(int t, char *pt){
+  s = t%60;
+  TwoDigits(s, pt);
+}
+
+void getMinutes(int t, char *pt){
+  m = (t/60)%60;
+  TwoDigits(m, pt);
+}
+
+void getHours(int t, char *pt){
+  h = (t/3600)%12;
+  if(h){
+    TwoDigits(h, pt);
+  }
+}
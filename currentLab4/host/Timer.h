@@ -0,0 +1,28 @@
+// -------------------------------------------------------------------
+// File name: Timer.h
+// Description: Host stand-in for the lab's Timer.c: the clock time in
+//              seconds on a 12 hour dial and its two digit fields
+//------------------------------------------------------------------------------
+#include <stdint.h>
+
+extern int time;                // seconds, 0 to 43199
+extern char sec[3], min[3], hour[3];
+extern uint32_t h, m, s;
+
+//------------updateTime------------
+// Input: flag nonzero if a second went by, t current time
+// Output: t one second later if flag is set, else t
+int updateTime(int flag, int t);
+
+//------------getSeconds------------
+// Two digits of the seconds of t into pt, the value into s
+void getSeconds(int t, char *pt);
+
+//------------getMinutes------------
+// Two digits of the minutes of t into pt, the value into m
+void getMinutes(int t, char *pt);
+
+//------------getHours------------
+// Two digits of the hour of t (1 to 11) into pt, the value into h; at
+// hour 0 pt is left alone, as in Timer.c
+void getHours(int t, char *pt);
@@ -0,0 +1,18 @@
+// -------------------------------------------------------------------
+// File name: Timer2.c
+// Description: Host stand-in for Valvano's Timer2 driver, see Timer2.h
+//------------------------------------------------------------------------------
+#include <stdint.h>
+#include "Sim.h"
+#include "Timer2.h"
+
+static void (*PeriodicTask2)(void);
+
+void Timer2A_Handler(void){
+  (*PeriodicTask2)();
+}
+
+void Timer2_Init(void(*task)(void), uint32_t period){
+  PeriodicTask2 = task;
+  Sim_Every(period, &Timer2A_Handler);
+}
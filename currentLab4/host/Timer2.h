@@ -0,0 +1,12 @@
+// -------------------------------------------------------------------
+// File name: Timer2.h
+// Description: Host stand-in for Valvano's Timer2 driver: a periodic
+//              Timer2A interrupt on the simulated bus clock
+//------------------------------------------------------------------------------
+#include <stdint.h>
+
+//------------Timer2_Init------------
+// Run task from the Timer2A interrupt every period bus cycles
+// Input: task user function, period in 12.5 ns units
+// Output: none
+void Timer2_Init(void(*task)(void), uint32_t period);
@@ -0,0 +1,18 @@
+// -------------------------------------------------------------------
+// File name: Timer3.c
+// Description: Host stand-in for Valvano's Timer3 driver, see Timer3.h
+//------------------------------------------------------------------------------
+#include <stdint.h>
+#include "Sim.h"
+#include "Timer3.h"
+
+static void (*PeriodicTask3)(void);
+
+void Timer3A_Handler(void){
+  (*PeriodicTask3)();
+}
+
+void Timer3_Init(void(*task)(void), uint32_t period){
+  PeriodicTask3 = task;
+  Sim_Every(period, &Timer3A_Handler);
+}
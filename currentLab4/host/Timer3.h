@@ -0,0 +1,12 @@
+// -------------------------------------------------------------------
+// File name: Timer3.h
+// Description: Host stand-in for Valvano's Timer3 driver: a periodic
+//              Timer3A interrupt on the simulated bus clock
+//------------------------------------------------------------------------------
+#include <stdint.h>
+
+//------------Timer3_Init------------
+// Run task from the Timer3A interrupt every period bus cycles
+// Input: task user function, period in 12.5 ns units
+// Output: none
+void Timer3_Init(void(*task)(void), uint32_t period);
@@ -0,0 +1,34 @@
+// -------------------------------------------------------------------
+// File name: UART.c
+// Description: Host stand-in for Valvano's UART driver, see UART.h
+//------------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdio.h>
+#include "UART.h"
+
+int UART_Echo;
+uint32_t UART_Chars;
+
+void UART_Init(uint32_t channel){
+  (void)channel;
+}
+
+void UART_OutChar(char data){
+  UART_Chars++;
+  if(UART_Echo){
+    putchar((data == '\r') ? '\n' : data);
+  }
+}
+
+void UART_OutString(char *pt){
+  while(*pt){
+    UART_OutChar(*pt++);
+  }
+}
+
+void UART_OutUDec(uint32_t n){
+  if(n >= 10){
+    UART_OutUDec(n/10);
+  }
+  UART_OutChar('0' + n%10);
+}
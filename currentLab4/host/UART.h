@@ -0,0 +1,15 @@
+// -------------------------------------------------------------------
+// File name: UART.h
+// Description: Host stand-in for Valvano's UART driver. Output goes to
+//              standard output when UART_Echo is set and is counted.
+//------------------------------------------------------------------------------
+#include <stdint.h>
+
+// host only: 1 to print what is sent, and characters sent
+extern int UART_Echo;
+extern uint32_t UART_Chars;
+
+void UART_Init(uint32_t channel);
+void UART_OutChar(char data);
+void UART_OutString(char *pt);
+void UART_OutUDec(uint32_t n);
@@ -0,0 +1,313 @@
+// -------------------------------------------------------------------
+// File name: esp8266.c
+// Description: Host stand-in for Valvano's ESP8266 driver and the module
+//              at the other end of UART5, see esp8266.h. Received
+//              messages wait in 8 buffers of 64 bytes, as in the driver,
+//              and ESP8266_GetMessage copies one up to its '\n'.
+//------------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "Sim.h"
+#include "esp8266.h"
+#include "Frame.h"
+
+#define ESP_RDY   (*((volatile uint32_t *)0x40024004))   // PE0
+#define ESP_RST   (*((volatile uint32_t *)0x40024008))   // PE1, low holds it in reset
+#define ESP_ACK   (*((volatile uint32_t *)0x40024020))   // PE3, high once set up
+#define MSGS      8             // receive buffers, must be a power of 2
+#define MSGSIZE   64
+#define WIRE      16            // messages on the way, must be a power of 2
+#define LINESIZE  128
+
+#define OFF       0             // held in reset
+#define BOOTING   1
+#define READY     2             // RDY high, waiting for the credentials
+#define JOINING   3
+#define UP        4
+#define VP_FRAMING 98           // as in Blynk.c
+
+static char ssid[] = "host";
+static char pass[] = "loopback";
+static char auth[] = "0123456789abcdef0123456789abcdef";
+
+int Loopback_Up;
+uint32_t Loopback_Records;
+uint32_t Loopback_Bad;
+int Loopback_Binary;
+uint32_t Loopback_TxBytes;
+uint32_t Loopback_RxBytes;
+uint32_t Loopback_Value[LOOP_PINS];
+uint32_t Loopback_Count[LOOP_PINS];
+
+static int State;
+static uint32_t Frames;                 // LOOP_FRAMES if it knows Frame.h
+static char Msg[MSGS][MSGSIZE];         // the driver's receive buffers
+static uint32_t MsgPutI, MsgGetI;
+static char Wire[WIRE][MSGSIZE];        // sent by the module, not yet received
+static uint32_t WirePutI, WireGetI;
+static uint64_t WireFree;               // cycle the UART is done with what is queued
+static uint64_t Outage;                 // cycle the Blynk server is back
+static char Line[LINESIZE];             // line from the TM4C being assembled
+static uint32_t LineN;
+
+//------------------------------- the driver -----------------------------------
+void Rx5Fifo_Init(void){
+  MsgPutI = MsgGetI = 0;
+}
+
+void ESP8266_Init(void){
+  Rx5Fifo_Init();
+  LineN = 0;
+}
+
+int ESP8266_GetMessage(char *datapt){
+  char *msg;
+  int i = 0;
+  if(MsgPutI == MsgGetI){
+    return 0;
+  }
+  msg = Msg[MsgGetI & (MSGS-1)];
+  do{
+    datapt[i] = msg[i];
+  }while((msg[i++] != '\n') && (i < MSGSIZE));
+  MsgGetI++;
+  return 1;
+}
+
+// bring-up steps, as ESP8266_Reset and ESP8266_SetupWiFi take them
+#define SETUP_RESET     0       // reset low for 5 s
+#define SETUP_BOOT      1       // reset high, 5 s to boot
+#define SETUP_READY     2       // waiting for RDY high
+#define SETUP_JOIN      3       // credentials sent, waiting for RDY low
+#define SETUP_DONE      4
+#define SETUP_HOLD_MS     5000
+#define SETUP_TIMEOUT_MS  20000 // RDY wait before another reset
+static uint32_t Setup, SetupDeadline;
+
+static void SetupWait(uint32_t step, uint32_t ms, uint32_t wait){
+  Setup = step;
+  SetupDeadline = ms + wait;
+}
+
+void ESP8266_Begin(uint32_t ms){
+  ESP8266_Init();
+  ESP_RST = 0;                  // reset the WiFi module
+  SetupWait(SETUP_RESET, ms, SETUP_HOLD_MS);
+}
+
+int ESP8266_Setup(uint32_t ms){ char msg[MSGSIZE];
+  int late = (int32_t)(ms - SetupDeadline) >= 0;
+  switch(Setup){
+    case SETUP_RESET:
+      if(!late) return ESP8266_WAITING;
+      ESP_RST = 0x02;
+      SetupWait(SETUP_BOOT, ms, SETUP_HOLD_MS);
+      return ESP8266_STEPPED;
+    case SETUP_BOOT:
+      if(!late) return ESP8266_WAITING;
+      ESP_ACK = 0;
+      SetupWait(SETUP_READY, ms, SETUP_TIMEOUT_MS);
+      return ESP8266_STEPPED;
+    case SETUP_READY:           // setup communications to the Blynk server
+      if(ESP_RDY == 0){
+        if(!late) return ESP8266_WAITING;
+        break;                  // no answer, reset again
+      }
+      ESP8266_OutString(auth);
+      ESP8266_OutChar(',');
+      ESP8266_OutString(ssid);
+      ESP8266_OutChar(',');
+      ESP8266_OutString(pass);
+      ESP8266_OutChar(',');
+      ESP8266_OutChar('\n');
+      SetupWait(SETUP_JOIN, ms, SETUP_TIMEOUT_MS);
+      return ESP8266_STEPPED;
+    case SETUP_JOIN:
+      if(ESP_RDY){
+        if(!late) return ESP8266_WAITING;
+        break;
+      }
+      while(ESP8266_GetMessage(msg)){};   // drop the chatter from the join
+      Rx5Fifo_Init();
+      ESP_ACK = 0x08;
+      Setup = SETUP_DONE;
+      return ESP8266_READY;
+    default:
+      return ESP8266_READY;
+  }
+  ESP_RST = 0;                  // the module timed out, start over
+  SetupWait(SETUP_RESET, ms, SETUP_HOLD_MS);
+  return ESP8266_RETRY;
+}
+
+int ESP8266_Connected(void){
+  return (Setup == SETUP_DONE) && (ESP_RDY == 0);
+}
+
+static void Record(const char *line);
+
+void ESP8266_OutChar(char data){
+  if(State == UP){
+    Loopback_TxBytes++;
+  }
+  if(LineN < LINESIZE-1){
+    Line[LineN++] = data;
+  }
+  if(data == '\n'){
+    Line[LineN] = 0;
+    LineN = 0;
+    Record(Line);
+  }
+}
+
+void ESP8266_OutString(char *pt){
+  while(*pt){
+    ESP8266_OutChar(*pt++);
+  }
+}
+
+//------------------------------- the module -----------------------------------
+static void Booted(uint32_t arg){
+  (void)arg;
+  if(State == BOOTING){
+    State = READY;
+    ESP_RDY = 0x01;
+  }
+}
+
+static void Joined(uint32_t arg){
+  (void)arg;
+  if((State == JOINING) && (Sim_Now >= Outage)){  // no join without the server
+    State = UP;
+    Loopback_Up = 1;
+    ESP_RDY = 0;
+  }
+}
+
+// follows the reset line
+static void Watch(void){
+  if((ESP_RST & 0x02) == 0){
+    State = OFF;
+    Loopback_Up = 0;
+    Loopback_Binary = 0;
+    ESP_RDY = 0;
+  } else if(State == OFF){
+    State = BOOTING;
+    Sim_At(Sim_Now + (uint64_t)LOOP_BOOT_MS*(SIM_HZ/1000), &Booted, 0);
+  }
+}
+
+void Loopback_Drop(uint32_t ms){
+  Outage = Sim_Now + (uint64_t)ms*(SIM_HZ/1000);
+  if(State != OFF){
+    State = READY;                    // waiting for the credentials again
+    ESP_RDY = 0x01;
+  }
+  Loopback_Up = 0;
+  Loopback_Binary = 0;
+}
+
+// pin and value of a "pin,value,float\n" line, 0 if it is not one
+static int Csv(const char *pt, uint32_t *pin, uint32_t *value){
+  uint32_t p = 0, v = 0;
+  if((*pt < '0') || (*pt > '9')){
+    return 0;
+  }
+  while((*pt >= '0') && (*pt <= '9')){
+    p = 10*p + (*pt++ - '0');
+  }
+  if(*pt++ != ','){
+    return 0;
+  }
+  while((*pt >= '0') && (*pt <= '9')){
+    v = 10*v + (*pt++ - '0');
+  }
+  if((p >= LOOP_PINS) || (*pt != ',')){
+    return 0;
+  }
+  *pin = p;
+  *value = v;
+  return 1;
+}
+
+// a whole line from the TM4C: the credentials, then records for the app
+static void Record(const char *line){
+  uint32_t pin, value;
+  if(State == READY){
+    State = JOINING;
+    Sim_At(Sim_Now + (uint64_t)LOOP_JOIN_MS*(SIM_HZ/1000), &Joined, 0);
+    return;
+  }
+  if(State != UP){
+    return;
+  }
+  if((uint8_t)line[0] & FRAME_FLAG){
+    if(!Frames || !Frame_Decode(line, LINESIZE, &pin, &value) || (pin >= LOOP_PINS)){
+      Loopback_Bad++;
+      return;
+    }
+  } else if(Csv(line, &pin, &value) == 0){
+    Loopback_Bad++;
+    return;
+  }
+  if((pin == VP_FRAMING) && (value == 1) && Frames){
+    Loopback_Binary = 1;        // offered, answer in binary from now on
+  }
+  Loopback_Value[pin] = value;
+  Loopback_Count[pin]++;
+  Loopback_Records++;
+}
+
+// the oldest message on the wire is in, it takes a receive buffer if one
+// is free; the driver drops it otherwise
+static void Arrived(uint32_t arg){
+  (void)arg;
+  if((MsgPutI - MsgGetI) < MSGS){
+    memcpy(Msg[MsgPutI & (MSGS-1)], Wire[WireGetI & (WIRE-1)], MSGSIZE);
+    MsgPutI++;
+  }
+  WireGetI++;
+}
+
+uint64_t Loopback_Line(const char *line){
+  uint32_t n = strlen(line);
+  if(((WirePutI - WireGetI) >= WIRE) || (n > MSGSIZE)){
+    fprintf(stderr, "Loopback: wire full or line too long\n");
+    return Sim_Now;
+  }
+  memset(Wire[WirePutI & (WIRE-1)], 0, MSGSIZE);
+  memcpy(Wire[WirePutI & (WIRE-1)], line, n);
+  WirePutI++;
+  if(WireFree < Sim_Now){
+    WireFree = Sim_Now;
+  }
+  WireFree += (uint64_t)n*SIM_UART_BYTE;
+  Loopback_RxBytes += n;
+  Sim_At(WireFree, &Arrived, 0);
+  return WireFree;
+}
+
+uint64_t Loopback_Write(uint32_t pin, uint32_t value){
+  char line[MSGSIZE];
+  if(Loopback_Binary){
+    *Frame_Encode(line, pin, value) = 0;
+  } else{
+    snprintf(line, sizeof(line), "%u,%u,0.0\n", (unsigned)pin, (unsigned)value);
+  }
+  return Loopback_Line(line);
+}
+
+void Loopback_Init(uint32_t frames){
+  Frames = frames;
+  State = OFF;
+  Loopback_Up = Loopback_Binary = 0;
+  Loopback_Records = Loopback_Bad = 0;
+  Loopback_TxBytes = Loopback_RxBytes = 0;
+  memset(Loopback_Value, 0, sizeof(Loopback_Value));
+  memset(Loopback_Count, 0, sizeof(Loopback_Count));
+  MsgPutI = MsgGetI = WirePutI = WireGetI = 0;
+  WireFree = Outage = 0;
+  LineN = 0;
+  Sim_Watch(&Watch);
+}
@@ -0,0 +1,99 @@
+// -------------------------------------------------------------------
+// File name: esp8266.h
+// Description: Host stand-in for Valvano's ESP8266 driver and for the
+//              ESP8266 at the other end of UART5. The module comes out of
+//              reset on PE1, raises RDY on PE0 once booted and lowers it
+//              again after it has joined with the credentials the TM4C
+//              sends. After that every line from the TM4C is taken as a
+//              Blynk record for the app, and values the app writes come
+//              back as "pin,value,0.0\n" lines at UART speed. Started with
+//              LOOP_FRAMES it is a module that knows Frame.h: once the
+//              TM4C offers binary records on VP98 it answers in them.
+//              Loopback_Drop takes the Blynk server away for a while, and
+//              the module raises RDY as it does when it needs setting up.
+//------------------------------------------------------------------------------
+#include <stdint.h>
+
+#ifndef ESP8266_H
+#define ESP8266_H
+void ESP8266_Init(void);
+void Rx5Fifo_Init(void);
+int ESP8266_GetMessage(char *datapt);
+void ESP8266_OutChar(char data);
+void ESP8266_OutString(char *pt);
+
+// ESP8266_Setup results
+#define ESP8266_WAITING 0       // on the module or a deadline, call again later
+#define ESP8266_STEPPED 1       // moved on, call again right away
+#define ESP8266_RETRY   2       // the module did not answer, it is reset again
+#define ESP8266_READY   3       // joined, messages are Blynk records from now on
+
+//------------ESP8266_Begin------------
+// Start the bring-up that ESP8266_Reset and ESP8266_SetupWiFi busy wait
+// through: enable UART5 and hold the module in reset
+// Input: ms time now in ms, from any free-running clock
+// Output: none
+void ESP8266_Begin(uint32_t ms);
+
+//------------ESP8266_Setup------------
+// One step of the bring-up, it never waits: reset held low for 5 s, 5 s
+// to boot, RDY high, the Blynk credentials sent, RDY low once the module
+// has joined, then ACK high. A wait of more than 20 s for RDY starts over
+// with another reset.
+// Input: ms time now, on the clock given to ESP8266_Begin
+// Output: ESP8266_xxx
+int ESP8266_Setup(uint32_t ms);
+
+//------------ESP8266_Connected------------
+// The module keeps RDY low while it is joined and raises it again when it
+// loses the Blynk server, waiting to be set up anew
+// Input: none
+// Output: 1 once ESP8266_Setup has returned ESP8266_READY and RDY is low
+int ESP8266_Connected(void);
+
+// host only, the ESP8266 end of the link
+#define LOOP_BOOT_MS    1000    // from reset high to RDY
+#define LOOP_JOIN_MS    2000    // from the credentials to RDY low
+#define LOOP_PINS       100
+#define LOOP_CSV        0       // Loopback_Init: CSV lines only
+#define LOOP_FRAMES     1       // binary records once offered
+
+//------------Loopback_Drop------------
+// The module loses the Blynk server for ms: it raises RDY, lines from the
+// TM4C go nowhere, and joins fail until the server is back
+// Input: ms length of the outage
+// Output: none
+void Loopback_Drop(uint32_t ms);
+
+// 1 once the module has joined, and the records it passed to the app
+extern int Loopback_Up;
+extern uint32_t Loopback_Records;
+extern uint32_t Loopback_Bad;           // lines it could not parse
+extern int Loopback_Binary;             // 1 once it answers in binary records
+// bytes on the wire, TM4C to ESP8266 after the join and ESP8266 to TM4C
+extern uint32_t Loopback_TxBytes;
+extern uint32_t Loopback_RxBytes;
+// latest value the app got on each virtual pin and how many times
+extern uint32_t Loopback_Value[LOOP_PINS];
+extern uint32_t Loopback_Count[LOOP_PINS];
+
+//------------Loopback_Init------------
+// Power up the ESP8266 end, call after Sim_Init
+// Input: frames LOOP_CSV or LOOP_FRAMES
+// Output: none
+void Loopback_Init(uint32_t frames);
+
+//------------Loopback_Write------------
+// The app writes a virtual pin; it reaches the TM4C after its bytes have
+// crossed the UART, behind anything still on the wire, as a CSV line or
+// a binary record
+// Input: pin 0 to 99, value
+// Output: cycle the message is complete in the TM4C's receive buffer
+uint64_t Loopback_Write(uint32_t pin, uint32_t value);
+
+//------------Loopback_Line------------
+// Send a raw line to the TM4C, such as a damaged record
+// Input: line, with its '\n'
+// Output: cycle the message is complete in the TM4C's receive buffer
+uint64_t Loopback_Line(const char *line);
+#endif
@@ -0,0 +1,122 @@
+// -------------------------------------------------------------------
+// File name: tm4c123gh6pm.h
+// Description: Host stand-in for the TI register header, with the
+//              registers and bit fields the sources in this directory use,
+//              at their TM4C123GH6PM addresses. Sim_Init maps memory at
+//              those addresses, so the firmware reads and writes them as
+//              on the board and the simulation models what they do.
+//------------------------------------------------------------------------------
+#include <stdint.h>
+
+#ifndef TM4C123GH6PM_H
+#define TM4C123GH6PM_H
+#define HOST_REG(addr)          (*((volatile uint32_t *)(addr)))
+
+// GPIO Port D and Port F
+#define GPIO_PORTD_DIR_R        HOST_REG(0x40007400)
+#define GPIO_PORTD_AFSEL_R      HOST_REG(0x40007420)
+#define GPIO_PORTD_DEN_R        HOST_REG(0x4000751C)
+#define GPIO_PORTD_AMSEL_R      HOST_REG(0x40007528)
+#define GPIO_PORTD_PCTL_R       HOST_REG(0x4000752C)
+#define GPIO_PORTF_DATA_R       HOST_REG(0x400253FC)
+#define GPIO_PORTF_DIR_R        HOST_REG(0x40025400)
+#define GPIO_PORTF_IM_R         HOST_REG(0x40025410)
+#define GPIO_PORTF_RIS_R        HOST_REG(0x40025414)
+#define GPIO_PORTF_AFSEL_R      HOST_REG(0x40025420)
+#define GPIO_PORTF_DEN_R        HOST_REG(0x4002551C)
+#define GPIO_PORTF_PCTL_R       HOST_REG(0x4002552C)
+
+// SSI0
+#define SSI0_CR0_R              HOST_REG(0x40008000)
+#define SSI0_CR1_R              HOST_REG(0x40008004)
+#define SSI0_DR_R               HOST_REG(0x40008008)
+#define SSI0_SR_R               HOST_REG(0x4000800C)
+#define SSI0_DMACTL_R           HOST_REG(0x40008024)
+#define SSI_CR0_DSS_M           0x0000000F
+#define SSI_CR0_DSS_8           0x00000007
+#define SSI_CR0_DSS_16          0x0000000F
+#define SSI_CR1_SSE             0x00000002
+#define SSI_SR_TFE              0x00000001
+#define SSI_SR_TNF              0x00000002
+#define SSI_SR_BSY              0x00000010
+#define SSI_DMACTL_TXDMAE       0x00000002
+
+// PWM1 generator 3
+#define PWM1_ENABLE_R           HOST_REG(0x40029008)
+#define PWM1_3_CTL_R            HOST_REG(0x40029100)
+#define PWM1_3_LOAD_R           HOST_REG(0x40029110)
+#define PWM1_3_CMPA_R           HOST_REG(0x40029118)
+#define PWM1_3_GENA_R           HOST_REG(0x40029120)
+
+// Timer1 and wide timer 0
+#define TIMER1_CFG_R            HOST_REG(0x40031000)
+#define TIMER1_TAMR_R           HOST_REG(0x40031004)
+#define TIMER1_CTL_R            HOST_REG(0x4003100C)
+#define TIMER1_IMR_R            HOST_REG(0x40031018)
+#define TIMER1_ICR_R            HOST_REG(0x40031024)
+#define TIMER1_TAILR_R          HOST_REG(0x40031028)
+#define TIMER1_TAPR_R           HOST_REG(0x40031038)
+#define WTIMER0_CFG_R           HOST_REG(0x40036000)
+#define WTIMER0_TAMR_R          HOST_REG(0x40036004)
+#define WTIMER0_CTL_R           HOST_REG(0x4003600C)
+#define WTIMER0_TAILR_R         HOST_REG(0x40036028)
+#define WTIMER0_TBILR_R         HOST_REG(0x4003602C)
+#define WTIMER0_TAV_R           HOST_REG(0x40036050)
+#define WTIMER0_TBV_R           HOST_REG(0x40036054)
+#define TIMER_TAMR_TACDIR       0x00000010
+#define TIMER_TAMR_TAMR_PERIOD  0x00000002
+#define TIMER_CTL_TAEN          0x00000001
+#define TIMER_IMR_TATOIM        0x00000001
+#define TIMER_ICR_TATOCINT      0x00000001
+
+// EEPROM
+#define EEPROM_EEBLOCK_R        HOST_REG(0x400AF004)
+#define EEPROM_EEOFFSET_R       HOST_REG(0x400AF008)
+#define EEPROM_EERDWRINC_R      HOST_REG(0x400AF014)
+#define EEPROM_EEDONE_R         HOST_REG(0x400AF018)
+#define EEPROM_EESUPP_R         HOST_REG(0x400AF01C)
+#define EEPROM_EEDONE_WORKING   0x00000001
+#define EEPROM_EESUPP_ERETRY    0x00000004
+#define EEPROM_EESUPP_PRETRY    0x00000008
+
+// System control
+#define SYSCTL_RCC_R            HOST_REG(0x400FE060)
+#define SYSCTL_RCGC2_R          HOST_REG(0x400FE108)
+#define SYSCTL_SREEPROM_R       HOST_REG(0x400FE558)
+#define SYSCTL_RCGCTIMER_R      HOST_REG(0x400FE604)
+#define SYSCTL_RCGCGPIO_R       HOST_REG(0x400FE608)
+#define SYSCTL_RCGCDMA_R        HOST_REG(0x400FE60C)
+#define SYSCTL_RCGCPWM_R        HOST_REG(0x400FE640)
+#define SYSCTL_RCGCEEPROM_R     HOST_REG(0x400FE658)
+#define SYSCTL_RCGCWTIMER_R     HOST_REG(0x400FE65C)
+#define SYSCTL_PRTIMER_R        HOST_REG(0x400FEA04)
+#define SYSCTL_PRGPIO_R         HOST_REG(0x400FEA08)
+#define SYSCTL_PRDMA_R          HOST_REG(0x400FEA0C)
+#define SYSCTL_PRPWM_R          HOST_REG(0x400FEA40)
+#define SYSCTL_PREEPROM_R       HOST_REG(0x400FEA58)
+#define SYSCTL_PRWTIMER_R       HOST_REG(0x400FEA5C)
+#define SYSCTL_RCC_USEPWMDIV    0x00100000
+#define SYSCTL_RCGC2_GPIOD      0x00000008
+#define SYSCTL_PRGPIO_R3        0x00000008
+#define SYSCTL_SREEPROM_R0      0x00000001
+#define SYSCTL_RCGCEEPROM_R0    0x00000001
+#define SYSCTL_RCGCWTIMER_R0    0x00000001
+#define SYSCTL_PREEPROM_R0      0x00000001
+#define SYSCTL_PRWTIMER_R0      0x00000001
+
+// uDMA
+#define UDMA_CFG_R              HOST_REG(0x400FF004)
+#define UDMA_CTLBASE_R          HOST_REG(0x400FF008)
+#define UDMA_USEBURSTCLR_R      HOST_REG(0x400FF01C)
+#define UDMA_REQMASKCLR_R       HOST_REG(0x400FF024)
+#define UDMA_ENASET_R           HOST_REG(0x400FF028)
+#define UDMA_ALTCLR_R           HOST_REG(0x400FF034)
+#define UDMA_PRIOCLR_R          HOST_REG(0x400FF03C)
+#define UDMA_CHIS_R             HOST_REG(0x400FF504)
+#define UDMA_CHMAP1_R           HOST_REG(0x400FF514)
+
+// NVIC
+#define NVIC_EN0_R              HOST_REG(0xE000E100)
+#define NVIC_PRI1_R             HOST_REG(0xE000E404)
+#define NVIC_PRI5_R             HOST_REG(0xE000E414)
+#endif
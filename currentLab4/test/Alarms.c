@@ -0,0 +1,111 @@
+// -------------------------------------------------------------------
+// File name: Alarms.c
+// Description: Fills the alarm wheel with ALARM_MAX daily alarms, one-shot
+//              alarms and countdowns, cancels some, and steps two turns of
+//              the dial with seconds skipped now and then. Every Alarm_Tick
+//              is checked against a plain list of what is due, and the
+//              wheel entries visited per second are compared with the
+//              whole list a linear scan would walk.
+//------------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+#include "Alarm.h"
+#include "Check.h"
+
+#define WHEELSIZE 64            // as in Alarm.c
+
+static int At[ALARM_MAX];
+static int Live[ALARM_MAX];     // 0, or the ALARM_xxx type still pending
+static uint32_t Seed = 1;
+
+// what the list says goes off in (from, to], one-shots leave it
+static int Due(int from, int to){
+  int fired = 0;
+  for(int t = from + 1; t <= to; t++){
+    int dial = t%ALARM_DAY;
+    for(int i = 0; i < ALARM_MAX; i++){
+      if(Live[i] && (At[i] == dial)){
+        fired++;
+        if(Live[i] == ALARM_ONESHOT){
+          Live[i] = 0;
+        }
+      }
+    }
+  }
+  return fired;
+}
+
+static int Add(int now, int n){
+  int added = 0;
+  for(int k = 0; k < n; k++){
+    uint32_t kind = RandomBelow(&Seed, 3);
+    int at = RandomBelow(&Seed, ALARM_DAY), id;
+    if(kind == 2){
+      int after = 1 + RandomBelow(&Seed, ALARM_DAY - 1);
+      id = Alarm_After(after);
+      at = (now + after)%ALARM_DAY;
+    } else{
+      id = Alarm_Add(at, kind ? ALARM_ONESHOT : ALARM_DAILY);
+    }
+    if(id < 0) break;
+    At[id] = at;
+    Live[id] = (kind == 0) ? ALARM_DAILY : ALARM_ONESHOT;
+    added++;
+  }
+  return added;
+}
+
+int main(void){
+  int now = 1234, last, fired = 0, expected = 0, wrong = 0, added, live = 0, caught = 0;
+  uint32_t ticks = 0;
+  double ns = 0;
+  struct timespec t0, t1;
+  printf("Alarm wheel, %d entries\n", ALARM_MAX);
+  Alarm_Init(now);
+  added = Add(now, ALARM_MAX + 10);
+  Check("pool holds ALARM_MAX entries", (added == ALARM_MAX) && (Alarm_After(5) < 0));
+  for(int i = 0; i < ALARM_MAX; i += 5){
+    Alarm_Remove(i);                    // cancel every fifth
+    Live[i] = 0;
+  }
+  Check("a cancelled entry can be used again", Add(now, ALARM_MAX) == (ALARM_MAX + 4)/5);
+  for(int i = 0; i < ALARM_MAX; i++){
+    live += Live[i] != 0;
+  }
+  while(now < 1234 + 2*ALARM_DAY){
+    int n;
+    last = now;
+    if(RandomBelow(&Seed, 10) == 0){
+      now += 2 + RandomBelow(&Seed, 5);   // the loop missed a few seconds
+    } else{
+      now++;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    n = Alarm_Tick(now%ALARM_DAY);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    ns += (t1.tv_sec - t0.tv_sec)*1e9 + (t1.tv_nsec - t0.tv_nsec);
+    int due = Due(last, now);
+    if(n != due) wrong++;
+    if(now - last > 1) caught += n;
+    fired += n;
+    expected += due;
+    ticks++;
+    if((ticks%5000) == 0){
+      Add(now%ALARM_DAY, 20);           // room left by one-shots that went off
+    }
+  }
+  printf("  %d pending at the start, %u ticks, %d went off, %d of them in a skip\n", live,
+         (unsigned)ticks, fired, caught);
+  printf("  wheel entries visited per second: mean %.1f, max %u; a linear scan %d\n",
+         (double)Alarm_Visits/(2*ALARM_DAY), (unsigned)Alarm_MaxVisits, ALARM_MAX);
+  printf("  host %.0f ns per Alarm_Tick\n", ns/ticks);
+  Check("every tick fired exactly what was due", (wrong == 0) && (fired == expected));
+  Check("alarms in skipped seconds still fired", caught > 0);
+  Check("mean visits per second about ALARM_MAX/WHEELSIZE",
+        Alarm_Visits <= 2ull*ALARM_DAY*(ALARM_MAX/WHEELSIZE + 1));
+  Check("most visits in one second under a tenth of a scan", Alarm_MaxVisits < ALARM_MAX/10);
+
+  Check("setting the clock 3 h forward fires nothing", Alarm_Tick((now + 3*3600)%ALARM_DAY) == 0);
+  return Check_Exit();
+}
@@ -0,0 +1,340 @@
+// -------------------------------------------------------------------
+// File name: Bench.c
+// Description: Boots the firmware on the host simulation with the
+//              loopback ESP8266 and drives it the way the app would:
+//              link-up, a minute on the clock, the menu, a burst of field
+//              presses, the inactivity timeout and then a tour of the
+//              other phases. Prints what each step cost (SPI bytes, time
+//              and bytes per PhaseControl frame in each phase, wakeups and main loop passes, display
+//              queue, fills, VP latency, the longest interrupt-masked
+//              window) and times Blynk_Parse against the strtok parser it
+//              replaced. Exits non-zero if a check fails.
+//              Built as is, with DISPLAY_TILES, and with REDRAW_ALL, where
+//              PhaseControl redraws every widget as it did before the
+//              dirty bits; that build's SPI bytes/s are the Before column.
+//------------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "Sim.h"
+#include "ST7735.h"
+#include "esp8266.h"
+#include "Display.h"
+#include "Event.h"
+#include "Fill.h"
+#include "Tiles.h"
+#include "Text.h"
+#include "Digits.h"
+#include "Arena.h"
+#include "Check.h"
+
+#define PHASES 7
+#define LINK_UP 3
+#define FULLSCREEN (ST7735_TFTWIDTH*ST7735_TFTHEIGHT)
+// scratch buffers that take turns in the arena instead of each having its
+// own static array: the Text.c line bitmap, the Clock.c face band and, with
+// DISPLAY_TILES, the Tiles.c tile image
+#ifdef DISPLAY_TILES
+#define SCRATCH (1056 + 640 + 512)
+#else
+#define SCRATCH (1056 + 640)
+#endif
+
+// Blynk.c
+int Blynk_main(void);
+int Blynk_Parse(const char *pt, uint32_t *pin, uint32_t *integer, int32_t *fixed);
+extern uint8_t phase_num;
+extern uint32_t LinkState, FirstFrameMs, LinkUpMs;
+extern uint32_t LoopCount, PhaseBytes[PHASES], PhaseFrames[PHASES];
+extern uint32_t VpLatencyLast, VpLatencyMax;
+extern uint32_t Button_Presses, Button_Repeats;
+extern volatile uint32_t RxPutI, RxGetI;
+extern uint32_t TxBytesTotal;
+extern int temp_t, inAlarm;
+
+static uint64_t PhaseWire[PHASES];      // SPI bytes on the wire in each phase
+static uint64_t PhaseCycles[PHASES];    // time spent in each phase
+static uint64_t WireLast, CyclesLast;
+
+#if !defined(DISPLAY_TILES) && !defined(REDRAW_ALL)
+#define BEFORE
+// SPI bytes/s in each phase from the REDRAW_ALL build of this bench, the
+// same script with every widget redrawn on every PhaseControl pass
+static const uint32_t Before[PHASES] = {3296, 10263, 3542, 15458, 27161, 5480, 5039};
+#endif
+
+// longest masked window after boot, in cycles, with every event dispatched
+// inside one StartCritical pair as before PublishState; the settings write
+// of 5 EEPROM words at 110 us each was the longest thing under it
+#define MASKED_BEFORE 44000
+
+// every byte sent to the ST7735: driver calls and uDMA fills, a fill being
+// an 11 byte window plus its pixels
+static uint64_t Wire(void){
+  return ST7735_Bytes + 11ull*Fill_Count + 2ull*Fill_Pixels;
+}
+
+// charges new bytes and time to the phase the firmware is in when they go out
+static void Attribute(void){
+  uint64_t wire = Wire();
+  if(phase_num < PHASES){
+    PhaseWire[phase_num] += wire - WireLast;
+    PhaseCycles[phase_num] += Sim_Now - CyclesLast;
+  }
+  WireLast = wire;
+  CyclesLast = Sim_Now;
+}
+
+static void Run(uint32_t ms){
+  Sim_Run(Sim_Now + (uint64_t)ms*(SIM_HZ/1000));
+}
+
+// a tap on a Blynk button: pressed, released, then ms for the screen
+static void Tap(uint32_t pin, uint32_t ms){
+  Loopback_Write(pin, 1);
+  Loopback_Write(pin, 0);
+  Run(ms);
+}
+
+//------------------------------- parse ----------------------------------------
+// the baseline parser: copy the message, then strtok, strcpy and atoi
+static int Reference(const char *msg, uint32_t *pin, uint32_t *integer){
+  char serial_buf[64], Pin_Number[8], Pin_Integer[16], Pin_Float[16];
+  memcpy(serial_buf, msg, sizeof(serial_buf));
+  strcpy(Pin_Number, strtok(serial_buf, ","));
+  strcpy(Pin_Integer, strtok(NULL, ","));
+  strcpy(Pin_Float, strtok(NULL, ","));
+  *pin = atoi(Pin_Number);
+  *integer = atoi(Pin_Integer);
+  return 1;
+}
+
+static double Seconds(void){
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec + 1e-9*t.tv_nsec;
+}
+
+#define PARSES 2000000
+static void Parse(void){
+  static const char *msgs[4] = {"1,1,0.0\n", "3,0,0.0\n", "5,31500,0.0\n", "8,2,1.250\n"};
+  char buf[4][64];
+  uint32_t pin, integer, sum0 = 0, sum1 = 0, same = 1;
+  int32_t fixed;
+  double t0, t1, t2;
+  for(int i = 0; i < 4; i++){
+    memset(buf[i], 0, 64);
+    strcpy(buf[i], msgs[i]);
+  }
+  t0 = Seconds();
+  for(int i = 0; i < PARSES; i++){
+    Reference(buf[i & 3], &pin, &integer);
+    sum0 += pin + integer;
+  }
+  t1 = Seconds();
+  for(int i = 0; i < PARSES; i++){
+    Blynk_Parse(buf[i & 3], &pin, &integer, &fixed);
+    sum1 += pin + integer;
+  }
+  t2 = Seconds();
+  for(int i = 0; i < 4; i++){
+    uint32_t p0, i0, p1, i1;
+    Reference(buf[i], &p0, &i0);
+    same &= Blynk_Parse(buf[i], &p1, &i1, &fixed) && (p0 == p1) && (i0 == i1);
+  }
+  printf("parse (host ns/message)\n");
+  printf("  strtok reference %.1f, Blynk_Parse %.1f\n",
+         1e9*(t1 - t0)/PARSES, 1e9*(t2 - t1)/PARSES);
+  Check("Blynk_Parse agrees with the strtok parser", same && (sum0 == sum1));
+}
+
+//------------------------------- firmware -------------------------------------
+int main(void){
+  uint32_t loops, wakeups, dispatches, messages, presses, windows;
+  uint64_t wire, blocked, dma;
+#ifdef DISPLAY_TILES
+  printf("Lab 4 host bench, DISPLAY_TILES\n");
+#else
+  printf("Lab 4 host bench\n");
+#endif
+  Sim_Init();
+  Loopback_Init(LOOP_CSV);
+  Sim_Watch(&Attribute);
+  Sim_Boot(&Blynk_main);
+
+  Run(20000);
+  printf("boot\n");
+  printf("  first frame %u ms, link up %u ms\n", (unsigned)FirstFrameMs, (unsigned)LinkUpMs);
+  Check("first frame within 1 s of power-on", FirstFrameMs < 1000);
+  Check("link up within 20 s", LinkState == LINK_UP);
+  Sim_MaskedMax = 0;                    // boot runs masked until its inits are done
+
+  loops = LoopCount;
+  wakeups = Event_Wakeups;
+  dispatches = Event_Dispatches;
+  wire = PhaseWire[0];
+  blocked = Sim_BlockedCycles;
+  Run(60000);
+  printf("clock, 60 s in phase 0\n");
+  printf("  per second: %.1f loop passes, %.1f wakeups, %.1f events, %.0f SPI bytes\n",
+         (LoopCount - loops)/60.0, (Event_Wakeups - wakeups)/60.0,
+         (Event_Dispatches - dispatches)/60.0, (PhaseWire[0] - wire)/60.0);
+  printf("  CPU blocked on SPI %.3f%%\n", 100.0*(Sim_BlockedCycles - blocked)/(60.0*SIM_HZ));
+  Check("main loop sleeps between events (< 500 passes/s)", (LoopCount - loops) < 500*60);
+  Check("published every second to the app", Loopback_Count[76] >= 59);
+
+  blocked = Sim_BlockedCycles;
+  dma = Sim_DmaCycles;
+  Tap(1, 1000);
+  printf("menu\n");
+  printf("  enter: %llu SPI bytes, CPU blocked %.2f ms, uDMA %.2f ms\n",
+         (unsigned long long)PhaseWire[1], (Sim_BlockedCycles - blocked)*1000.0/SIM_HZ,
+         (Sim_DmaCycles - dma)*1000.0/SIM_HZ);
+#ifndef DISPLAY_TILES
+  printf("  clear by CPU would block %.2f ms\n", (11.0 + 2.0*FULLSCREEN)*SIM_SPI_BYTE*1000.0/SIM_HZ);
+  Check("screen clear sent by uDMA", (Sim_DmaCycles - dma) >= 2ull*FULLSCREEN*SIM_SPI_BYTE);
+  Check("CPU blocked less than the clear takes", (Sim_BlockedCycles - blocked) <
+        (Sim_DmaCycles - dma));
+#endif
+  Check("in the menu", phase_num == 1);
+  wire = PhaseWire[1];
+  for(int i = 0; i < 4; i++){
+    Tap(2, 300);                        // highlight all the way round
+  }
+  printf("  highlight move: %llu SPI bytes\n", (unsigned long long)(PhaseWire[1] - wire)/4);
+#if defined(DISPLAY_TILES)
+  Check("highlight move resends the tiles of two items (< 8 KB)", (PhaseWire[1] - wire)/4 < 8192);
+#elif !defined(REDRAW_ALL)
+  Check("highlight move redraws two items (< 2 KB)", (PhaseWire[1] - wire)/4 < 2048);
+#endif
+
+  Tap(1, 500);                          // Set Clock, the hour field is highlighted
+  Tap(1, 500);                          // select it
+  Check("in the set clock screen", phase_num == 2);
+  messages = RxGetI;
+  presses = Button_Presses;
+  windows = Text_Windows;
+  wire = PhaseWire[2];
+  for(int i = 0; i < 6; i++){
+    Loopback_Write(3, 1);               // up, as fast as the UART goes
+  }
+  Loopback_Write(3, 0);
+  Run(1000);
+  printf("burst of 6 up presses\n");
+  printf("  %u messages, %u presses, %u repeats, %u strings drawn, %llu SPI bytes\n",
+         (unsigned)(RxGetI - messages), (unsigned)(Button_Presses - presses),
+         (unsigned)Button_Repeats, (unsigned)(Text_Windows - windows),
+         (unsigned long long)(PhaseWire[2] - wire));
+  printf("  VP latency last %u us, max %u us\n", (unsigned)VpLatencyLast, (unsigned)VpLatencyMax);
+  Check("every message consumed", (RxGetI - messages) == 7);
+  Check("streak steps 1,1,1,1,5,5 hours from 8", temp_t/3600 == (8 + 14)%12);
+#ifndef REDRAW_ALL
+  Check("one redraw for the burst", (Text_Windows - windows) <= 1);
+#endif
+  Check("VP latency under 100 ms", VpLatencyMax < 100000);
+  messages = RxGetI;
+  windows = Text_Windows;
+  for(int i = 0; i < 4; i++){
+    Loopback_Write(2, 1);               // down, tapped four times
+    Loopback_Write(2, 0);
+  }
+  Run(1000);
+  printf("burst of 4 down taps\n");
+  printf("  %u messages, %u strings drawn\n", (unsigned)(RxGetI - messages),
+         (unsigned)(Text_Windows - windows));
+  Check("taps merged into one step of 4 hours", (RxGetI - messages == 8) && (temp_t/3600 == 6));
+#ifndef REDRAW_ALL
+  Check("one redraw for the taps", (Text_Windows - windows) <= 1);
+#endif
+
+  Run(30000);                           // untouched, back to the clock
+  Check("back on the clock after 25 s", phase_num == 0);
+
+  Check("alarm sounding since 8:47", inAlarm == 1);
+  Tap(2, 500);                          // silence it
+  Tap(4, 10000);                        // the two other clock displays
+  Check("mode button to clock display 2", phase_num == 5);
+  Tap(4, 10000);
+  Check("mode button to clock display 3", phase_num == 6);
+  Tap(4, 1000);
+  Tap(1, 500);                          // menu, Set Alarm, hour field
+  Tap(2, 500);
+  Tap(1, 500);
+  Check("in the set alarm screen", phase_num == 3);
+  Tap(1, 500);
+  for(int i = 0; i < 3; i++){
+    Tap(3, 600);                        // one step at a time
+  }
+  Tap(1, 500);
+  for(int i = 0; i < 4; i++){
+    Tap(2, 500);                        // round to Back
+  }
+  Tap(1, 500);
+  Tap(2, 500);                          // Stop Watch
+  Tap(2, 500);
+  Tap(1, 500);
+  Check("in the stopwatch", phase_num == 4);
+  Tap(1, 10000);                        // Start, 10 s running
+  Tap(1, 500);                          // stop
+  Tap(2, 500);                          // Back
+  Tap(2, 500);
+  Tap(1, 500);
+  Run(30000);
+  Check("back on the clock after the tour", phase_num == 0);
+  printf("display queue\n");
+  printf("  max depth %u, coalesced %u, fills %u (%u pixels), digit blits %u\n",
+         (unsigned)Display_MaxDepth, (unsigned)Display_Coalesced, (unsigned)Fill_Count,
+         (unsigned)Fill_Pixels, (unsigned)Digits_Blits);
+#ifdef DISPLAY_TILES
+  printf("  tiles sent %u, palette full %u\n", (unsigned)Tiles_Sent, (unsigned)Tiles_PaletteFull);
+#endif
+  printf("arena\n");
+  printf("  peak bytes: boot %u, setup %u, run %u of %d; %u did not fit\n",
+         (unsigned)Arena_PhasePeak[ARENA_BOOT], (unsigned)Arena_PhasePeak[ARENA_SETUP],
+         (unsigned)Arena_PhasePeak[ARENA_RUN], ARENA_SIZE, (unsigned)Arena_Failed);
+  printf("  %d bytes of scratch buffers in %d, %d bytes freed\n", SCRATCH, ARENA_SIZE,
+         SCRATCH - ARENA_SIZE);
+  Check("every scratch buffer fit in the arena", Arena_Failed == 0);
+  printf("SPI bytes by phase\n");
+  printf("  phase  seconds      bytes  bytes/s  frames bytes/frame");
+#ifdef BEFORE
+  printf("   before");
+#endif
+  printf("\n");
+#ifdef BEFORE
+  int fewer = 1;
+#endif
+  int framed = 1;
+  for(int i = 0; i < PHASES; i++){
+    double seconds = (double)PhaseCycles[i]/SIM_HZ;
+    printf("  %5d %8.1f %10llu %8.0f %7u %11.0f", i, seconds, (unsigned long long)PhaseWire[i],
+           PhaseWire[i]/seconds, (unsigned)PhaseFrames[i], (double)PhaseWire[i]/PhaseFrames[i]);
+    framed &= (PhaseFrames[i] != 0) && (PhaseWire[i] != 0);
+#ifdef BEFORE
+    printf(" %8u", (unsigned)Before[i]);
+    if((i >= 1) && (i <= 4)){
+      fewer &= PhaseWire[i]/seconds < Before[i];
+    }
+#endif
+    printf("\n");
+  }
+  Check("every phase drew frames and sent bytes", framed);
+#ifdef BEFORE
+  Check("menus (phases 1-4) send fewer bytes/s than before", fewer);
+#endif
+  printf("link\n");
+  printf("  to the app %u bytes, %u records, %u bad; from the app %u bytes\n",
+         (unsigned)Loopback_TxBytes, (unsigned)Loopback_Records, (unsigned)Loopback_Bad,
+         (unsigned)Loopback_RxBytes);
+  Check("app could read every record", Loopback_Bad == 0);
+  Check("no event dropped", Event_Dropped == 0);
+  printf("interrupts\n");
+  printf("  longest masked window after boot %.1f us, before %.1f us\n",
+         (double)Sim_MaskedMax/(SIM_HZ/1000000), (double)MASKED_BEFORE/(SIM_HZ/1000000));
+  Check("no EEPROM or SPI wait with interrupts masked", Sim_MaskedMax < SIM_SPI_BYTE);
+
+  Parse();
+  return Check_Exit();
+}
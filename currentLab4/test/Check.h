@@ -0,0 +1,52 @@
+// -------------------------------------------------------------------
+// File name: Check.h
+// Description: Shared by the programs in test/. Check prints one line per
+//              property a test checks and counts the failures, Check_Exit
+//              prints the verdict and turns it into the exit status ctest
+//              reads, and Random is the linear congruential generator the
+//              tests draw their inputs from, so a run is repeatable. Every
+//              test is a program of its own, so these are static.
+//------------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdio.h>
+
+#ifndef CHECK_H
+#define CHECK_H
+static int Failed;              // checks that did not hold
+
+//------------Check------------
+// Print what was checked and whether it held
+// Input: what one line description, ok nonzero if it held
+// Output: none
+static inline void Check(const char *what, int ok){
+  printf("  %-52s %s\n", what, ok ? "ok" : "FAILED");
+  if(!ok){
+    Failed++;
+  }
+}
+
+//------------Check_Exit------------
+// Print passed or FAILED, return this from main
+// Input: none
+// Output: 0 if every check held, 1 otherwise
+static inline int Check_Exit(void){
+  printf("%s\n", Failed ? "FAILED" : "passed");
+  return Failed != 0;
+}
+
+//------------Random------------
+// Step a generator; each thread or stream keeps its own seed
+// Input: seed state, any start value
+// Output: the next 32-bit value
+static inline uint32_t Random(uint32_t *seed){
+  *seed = 1664525*(*seed) + 1013904223;
+  return *seed;
+}
+
+//------------RandomBelow------------
+// Input: seed state, n bound
+// Output: the next value from 0 to n-1, taken from the high bits
+static inline uint32_t RandomBelow(uint32_t *seed, uint32_t n){
+  return (Random(seed) >> 8)%n;
+}
+#endif
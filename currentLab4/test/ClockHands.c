@@ -0,0 +1,136 @@
+// -------------------------------------------------------------------
+// File name: ClockHands.c
+// Description: Checks the fixed-point clock against the floating-point
+//              one it replaced. The packed face must expand to the lab's
+//              clockFace, checked by CRC-32. The reference hands use
+//              sin/cos with PI = 3.14159 as the original drawHands did,
+//              drawn with ST7735_4Line into a copy of the face. All 720
+//              dial positions are drawn on a fresh face and one after the
+//              other by Clock_DrawHands, and the screen must match the
+//              reference pixel for pixel every time.
+//------------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "ST7735.h"
+#include "Clock.h"
+#include "Check.h"
+
+#define FACE_X    23            // as in Clock.c
+#define FACE_Y    140
+#define FACE_SIZE 80
+#define CX        61
+#define CY        100
+#define MINUTE_LEN  20
+#define HOUR_LEN    15
+#define PI          3.14159
+#define FACE_CRC  0x8A8A76DD    // clockFace in LCD.c, little-endian words
+
+extern const uint8_t ClockFace[FACE_SIZE*FACE_SIZE/4];
+extern const uint16_t ClockPalette[4];
+
+static uint16_t Face[FACE_SIZE*FACE_SIZE];
+static uint16_t Expect[ST7735_TFTHEIGHT][ST7735_TFTWIDTH];
+
+static uint32_t Crc32(const uint16_t *w, int n){
+  uint32_t crc = 0xFFFFFFFF;
+  for(int i = 0; i < 2*n; i++){
+    crc ^= (w[i/2] >> (8*(i%2))) & 0xFF;
+    for(int b = 0; b < 8; b++){
+      crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+    }
+  }
+  return ~crc;
+}
+
+//------------------------------- reference ------------------------------------
+static void Endpoint(int len, double deg, int *x, int *y){
+  double rad = PI*deg/180.0;
+  *x = CX + (int)(cos(rad)*len);
+  *y = CY - (int)(sin(rad)*len);
+}
+
+static void Plot(int x, int y, uint16_t color){
+  if((x >= 0) && (x < ST7735_TFTWIDTH) && (y >= 0) && (y < ST7735_TFTHEIGHT)){
+    Expect[y][x] = color;
+  }
+}
+
+// ST7735_Line: a vertical line is a DrawFastVLine one pixel short of the
+// lower end, anything else steps along its longer axis
+static void Line(int x1, int y1, int x2, int y2, uint16_t color){
+  int dx = abs(x2 - x1), dy = abs(y2 - y1);
+  if(x1 == x2){
+    for(int y = (y1 < y2) ? y1 : y2; y < ((y1 < y2) ? y2 : y1); y++){
+      Plot(x1, y, color);
+    }
+  } else if(dx >= dy){
+    for(int x = (x1 < x2) ? x1 : x2; x <= ((x1 < x2) ? x2 : x1); x++){
+      Plot(x, y1 + (y2 - y1)*(x - x1)/(x2 - x1), color);
+    }
+  } else{
+    for(int y = (y1 < y2) ? y1 : y2; y <= ((y1 < y2) ? y2 : y1); y++){
+      Plot(x1 + (x2 - x1)*(y - y1)/(y2 - y1), y, color);
+    }
+  }
+}
+
+static void Line4(int x, int y, uint16_t color){
+  Line(CX, CY, x, y, color);
+  Line(CX, CY + 1, x, y + 1, color);
+  Line(CX + 1, CY, x + 1, y, color);
+  Line(CX + 1, CY + 1, x + 1, y + 1, color);
+}
+
+// the screen after drawHands at minute position of the 12 hour dial
+static void Reference(int position){
+  int x, y;
+  memset(Expect, 0, sizeof(Expect));
+  for(int row = 0; row < FACE_SIZE; row++){
+    for(int col = 0; col < FACE_SIZE; col++){
+      Expect[FACE_Y - row][FACE_X + col] = Face[row*FACE_SIZE + col];
+    }
+  }
+  Endpoint(HOUR_LEN, 90 - position/2.0, &x, &y);
+  Line4(x, y, ST7735_BLUE);
+  Endpoint(MINUTE_LEN, 90 - 6*(position%60), &x, &y);
+  Line4(x, y, ST7735_WHITE);
+}
+
+static int Same(void){
+  return memcmp(ST7735_Frame, Expect, sizeof(Expect)) == 0;
+}
+
+int main(void){
+  int fresh = 0, moved = 0;
+  uint32_t bytes;
+  printf("Clock hands, fixed point against sin/cos\n");
+  for(int i = 0; i < FACE_SIZE*FACE_SIZE; i++){
+    Face[i] = ClockPalette[(ClockFace[i/4] >> (2*(i%4))) & 3];
+  }
+  Check("packed face expands to the lab's clockFace", Crc32(Face, FACE_SIZE*FACE_SIZE) == FACE_CRC);
+
+  Output_Init();
+  for(int p = 0; p < 720; p++){
+    ST7735_FillScreen(ST7735_BLACK);
+    Clock_DrawFace();
+    Clock_DrawHands(60*p);
+    Reference(p);
+    fresh += Same();
+  }
+  ST7735_FillScreen(ST7735_BLACK);
+  Clock_DrawFace();
+  bytes = ST7735_Bytes;
+  for(int p = 0; p < 2*720; p++){       // twice round, from 12 o'clock
+    Clock_DrawHands(60*(p%720));
+    Reference(p%720);
+    moved += Same();
+  }
+  printf("  %d of 720 positions match on a fresh face, %d of 1440 moving\n", fresh, moved);
+  printf("  %.1f bytes to the ST7735 a minute\n", (ST7735_Bytes - bytes)/1440.0);
+  Check("every position drawn on a fresh face", fresh == 720);
+  Check("every position reached by moving the hands", moved == 2*720);
+  return Check_Exit();
+}
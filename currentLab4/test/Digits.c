@@ -0,0 +1,103 @@
+// -------------------------------------------------------------------
+// File name: Digits.c
+// Description: Cost of one clock readout, before and after the sprite
+//              cache. Before is outputTime's path: the cursor at column 6
+//              and hh:mm:ss through ST7735_OutChar, which walks the font
+//              pixel by pixel into one address window per character.
+//              After is Digits_OutTime, one ST7735_DrawBitmap per
+//              character. Both must leave the same pixels. For each it
+//              prints the SPI transactions (address windows), bytes and
+//              cycles on SSI0 per call, and the host ns spent outside SPI
+//              composing the pixels. The stopwatch readout is checked the
+//              same way against outputTimer's mm:ss.mmm at column 8.
+//------------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "Sim.h"
+#include "ST7735.h"
+#include "Digits.h"
+#include "Check.h"
+
+#define CALLS 43200             // every second of the 12 hour dial
+#define ROW   2                 // phase 0 puts the time on row 2
+
+static uint16_t Expect[ST7735_TFTHEIGHT][ST7735_TFTWIDTH];
+
+typedef struct cost_t {
+  uint64_t windows, bytes, cycles, ns;
+} cost_t;
+
+// outputTime, as the lab's Timer.c drew it
+static void OutputTime(int t, int row){
+  char buf[16];
+  int h = (t/3600)%12, m = (t%3600)/60, s = t%60;
+  if(h == 0){
+    h = 12;
+  }
+  sprintf(buf, "%02d:%02d:%02d", h, m, s);
+  ST7735_SetCursor(6, row);
+  ST7735_OutString(buf);
+}
+
+// outputTimer
+static void OutputTimer(int t, int row){
+  char buf[16];
+  sprintf(buf, "%02d:%02d.%03d", (t/60000)%100, (t/1000)%60, t%1000);
+  ST7735_SetCursor(8, row);
+  ST7735_OutString(buf);
+}
+
+// one call of draw at every t, with the SPI time charged apart
+static void Measure(void (*draw)(int t, int row), cost_t *c){
+  uint32_t windows = ST7735_Windows, bytes = ST7735_Bytes;
+  uint64_t cycles = Sim_Now, t0 = Sim_HostNs();
+  for(int t = 0; t < CALLS; t++){
+    draw(t, ROW);
+  }
+  c->ns = Sim_HostNs() - t0;
+  c->windows = ST7735_Windows - windows;
+  c->bytes = ST7735_Bytes - bytes;
+  c->cycles = Sim_Now - cycles;
+}
+
+// the same screen from both, at every t
+static int Match(void (*before)(int t, int row), void (*after)(int t, int row), int step){
+  for(int t = 0; t < CALLS*step; t += step){
+    memset(ST7735_Frame, 0, sizeof(ST7735_Frame));
+    before(t, ROW);
+    memcpy(Expect, ST7735_Frame, sizeof(Expect));
+    memset(ST7735_Frame, 0, sizeof(ST7735_Frame));
+    after(t, ROW);
+    if(memcmp(Expect, ST7735_Frame, sizeof(Expect))){
+      return 0;
+    }
+  }
+  return 1;
+}
+
+static void Print(const char *name, const cost_t *c){
+  printf("  %-22s %5.1f %7.1f %9.1f %9.1f\n", name, (double)c->windows/CALLS,
+         (double)c->bytes/CALLS, (double)c->cycles/CALLS, (double)c->ns/CALLS);
+}
+
+int main(void){
+  cost_t before, after;
+  printf("Clock readout, font path against sprites\n");
+  Sim_Init();
+  Output_Init();
+  Output_Color(ST7735_WHITE);
+  Digits_Init();
+  Check("Digits_OutTime draws what outputTime did", Match(&OutputTime, &Digits_OutTime, 1));
+  Check("Digits_OutTimer draws what outputTimer did", Match(&OutputTimer, &Digits_OutTimer, 997));
+
+  Measure(&OutputTime, &before);
+  Measure(&Digits_OutTime, &after);
+  printf("  per call               windows   bytes SPI cycles  host ns\n");
+  Print("outputTime (before)", &before);
+  Print("Digits_OutTime (after)", &after);
+  Check("one address window per character", after.windows == 8ull*CALLS);
+  Check("no more SPI bytes than before", after.bytes <= before.bytes);
+  Check("less host time outside SPI than before", after.ns < before.ns);
+  return Check_Exit();
+}
@@ -0,0 +1,169 @@
+// -------------------------------------------------------------------
+// File name: DisplayOrder.c
+// Description: Checks that the display queue draws what the commands
+//              would have drawn one at a time. Coalescing drops a queued
+//              command once a later opaque command covers it, so a
+//              dropped command must never show through and a kept one must
+//              never be drawn out of order. Fills go through a port that
+//              paints the host frame buffer. Each sequence is drawn twice,
+//              flushing after every command and flushing once at the end,
+//              and the two screens must match pixel for pixel.
+//------------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "Sim.h"
+#include "ST7735.h"
+#include "Fill.h"
+#include "Display.h"
+#include "Event.h"
+#include "Profile.h"
+#include "Check.h"
+
+#define CASET 0x2A
+#define RASET 0x2B
+#define RAMWR 0x2C
+#define SEQUENCES 2000
+#define LONGEST   24            // commands in a sequence, past the queue size
+
+static uint16_t Expect[ST7735_TFTHEIGHT][ST7735_TFTWIDTH];
+static uint32_t Seed = 11;
+
+//------------------------------- fill port ------------------------------------
+// paints fills into ST7735_Frame: CASET and RASET open the window, the
+// pixels fill it row by row
+static uint8_t Cmd, Args[4];
+static int ArgN, X0, X1, Y0, Y1, X, Y;
+
+static void PortCommand(uint8_t c){
+  Cmd = c;
+  ArgN = 0;
+  if(c == RAMWR){
+    X = X0; Y = Y0;
+  }
+}
+
+static void PortData(uint8_t d){
+  Args[ArgN++] = d;
+  if(ArgN == 4){
+    if(Cmd == CASET){ X0 = Args[1]; X1 = Args[3]; }
+    if(Cmd == RASET){ Y0 = Args[1]; Y1 = Args[3]; }
+  }
+}
+
+static void PortPixels(uint16_t color, uint32_t n){
+  while(n--){
+    ST7735_Frame[Y][X] = color;
+    if(++X > X1){
+      X = X0;
+      Y++;
+    }
+  }
+}
+
+static const fill_port_t Painter = {&PortCommand, &PortData, &PortPixels, 0};
+
+//------------------------------- commands -------------------------------------
+static const uint16_t Colors[4] = {ST7735_RED, ST7735_GREEN, ST7735_BLUE, ST7735_WHITE};
+static const char *Texts[4] = {"12", "Set", "Back", "12:00"};
+
+// drawn by the routine itself, as Digits_OutTime is
+static void Block(int a, int b){
+  ST7735_FillRect(a, b, 7, 5, ST7735_MAGENTA);
+}
+
+typedef struct draw_t {
+  int type, x, y, w, h, color;
+} draw_t;
+
+static void Queue(const draw_t *d){
+  switch(d->type){
+    case 0:
+      Display_FillRect(d->x, d->y, d->w, d->h, Colors[d->color]);
+      break;
+    case 1:
+      Display_String(d->x/6, d->y/10, Texts[d->w%4], Colors[d->color]);
+      break;
+    case 2:
+      Display_Line(d->x, d->y, d->w + 20, d->h + 20, Colors[d->color]);
+      break;
+    case 3:
+      Display_Call(&Block, d->x, d->y);
+      break;
+  }
+}
+
+// one at a time into Expect, then queued into ST7735_Frame
+static int Same(const draw_t *d, int n){
+  memset(ST7735_Frame, 0, sizeof(ST7735_Frame));
+  for(int i = 0; i < n; i++){
+    Queue(&d[i]);
+    Display_Flush();
+  }
+  memcpy(Expect, ST7735_Frame, sizeof(Expect));
+  memset(ST7735_Frame, 0, sizeof(ST7735_Frame));
+  for(int i = 0; i < n; i++){
+    Queue(&d[i]);
+  }
+  Display_Flush();
+  return memcmp(Expect, ST7735_Frame, sizeof(Expect)) == 0;
+}
+
+// the screen at a pixel after the sequence, queued
+static uint16_t Pixel(const draw_t *d, int n, int x, int y){
+  Same(d, n);
+  return ST7735_Frame[y][x];
+}
+
+int main(void){
+  draw_t d[LONGEST];
+  uint32_t coalesced, matched = 0;
+  printf("Display queue order\n");
+  Sim_Init();
+  Profile_Init(0);
+  Event_Init();
+  Output_Init();
+  Fill_Init(&Painter);
+
+  // a string queued after an overlapping fill is drawn over it
+  d[0] = (draw_t){0, 0, 0, 60, 40, 0};
+  d[1] = (draw_t){1, 12, 10, 1, 0, 3};  // "Set" at column 2, row 1
+  coalesced = Display_Coalesced;
+  Check("string after an overlapping fill is drawn", Same(d, 2) &&
+        (Display_Coalesced == coalesced) && (Pixel(d, 2, 12, 10) != ST7735_RED));
+  // a fill queued after a string it covers hides it, the string is dropped
+  d[2] = d[1]; d[3] = d[0];
+  coalesced = Display_Coalesced;
+  Check("fill over a queued string drops the string", Same(&d[2], 2) &&
+        (Display_Coalesced == coalesced + 1));
+  // a routine queued between a fill and a string draws over the fill and
+  // under the string
+  d[4] = (draw_t){0, 0, 0, 60, 40, 1};
+  d[5] = (draw_t){3, 20, 26, 0, 0, 0};  // rows 26 to 30
+  d[6] = (draw_t){1, 18, 30, 3, 0, 3};  // "12:00" from row 30
+  Check("call between a fill and a string keeps its place", Same(&d[4], 3) &&
+        (Pixel(&d[4], 3, 20, 26) == ST7735_MAGENTA) &&
+        (Pixel(&d[4], 3, 20, 30) != ST7735_MAGENTA));
+
+  // random sequences on a small patch of the screen, so most commands overlap
+  coalesced = Display_Coalesced;
+  for(int s = 0; s < SEQUENCES; s++){
+    int n = 1 + RandomBelow(&Seed, LONGEST);
+    for(int i = 0; i < n; i++){
+      d[i].type = RandomBelow(&Seed, 8);
+      d[i].type = (d[i].type < 4) ? 0 : (d[i].type < 6) ? 1 : d[i].type - 4;
+      d[i].x = RandomBelow(&Seed, 60);
+      d[i].y = RandomBelow(&Seed, 50);
+      d[i].w = 1 + RandomBelow(&Seed, 40);
+      d[i].h = 1 + RandomBelow(&Seed, 30);
+      d[i].color = RandomBelow(&Seed, 4);
+    }
+    matched += Same(d, n);
+  }
+  printf("  %u of %d random sequences match, %u commands coalesced, max depth %u\n",
+         (unsigned)matched, SEQUENCES, (unsigned)(Display_Coalesced - coalesced),
+         (unsigned)Display_MaxDepth);
+  Check("every random sequence draws the same screen", matched == SEQUENCES);
+  Check("and coalescing happened", Display_Coalesced > coalesced);
+  return Check_Exit();
+}
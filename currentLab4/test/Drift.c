@@ -0,0 +1,117 @@
+// -------------------------------------------------------------------
+// File name: Drift.c
+// Description: Boots the firmware with the loopback ESP8266 and runs its
+//              main loop for 24 simulated hours with SysTick 0.5% fast,
+//              as if it ran from PIOSC/4 instead of the bus clock. The
+//              stopwatch is started from the app after boot and stopped a
+//              day later. Checks that the firmware's clock in time follows
+//              the timebase all day, never ahead of it and never more than
+//              a second behind, and that the stopwatch shows the day to
+//              the millisecond, both the value and the digits on screen.
+//              The timebase itself must never go back across the wraps of
+//              its low word.
+//------------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "Sim.h"
+#include "ST7735.h"
+#include "esp8266.h"
+#include "Systick.h"
+#include "Timer.h"
+#include "Timebase.h"
+#include "Digits.h"
+#include "Check.h"
+
+#define DAY       86400
+#define SKEWED    796000        // SysTick reload, 10 ms less 0.5%
+#define SW_ROW    6             // where phase 4 shows the stopwatch
+#define LATENCY   10            // ms a tap may wait for Timer2's next poll
+
+// Blynk.c
+int Blynk_main(void);
+extern uint8_t phase_num;
+extern int inAlarm;
+extern uint32_t time_sw;
+
+static uint64_t Last;
+static uint32_t Backwards, Wraps;
+static uint16_t Shown[ST7735_TFTHEIGHT][ST7735_TFTWIDTH];
+
+// every time the simulation gets control
+static void Monotonic(void){
+  uint64_t now = Timebase_Now();
+  if(now < Last) Backwards++;
+  if((uint32_t)now < (uint32_t)Last) Wraps++;
+  Last = now;
+}
+
+static void Run(uint32_t ms){
+  Sim_Run(Sim_Now + (uint64_t)ms*(SIM_HZ/1000));
+}
+
+static void Tap(uint32_t pin, uint32_t ms){
+  Loopback_Write(pin, 1);
+  Loopback_Write(pin, 0);
+  Run(ms);
+}
+
+// the clock the timebase says the firmware should show
+static int Expected(int start){
+  return (int)((start + Timebase_Now()/TIMEBASE_HZ)%43200);
+}
+
+int main(void){
+  int start, lag, maxLag = 0, ahead = 0, alarms = 0;
+  uint64_t swStart, swStop;
+  uint32_t elapsed;
+  printf("Clock and stopwatch drift over 24 h, SysTick 0.5%% fast\n");
+  Sim_Init();
+  Loopback_Init(LOOP_FRAMES);
+  Sim_Watch(&Monotonic);
+  SysTick_Period = SKEWED;
+  start = time;
+  Sim_Boot(&Blynk_main);
+  Run(20000);
+  Check("link up", Loopback_Up);
+
+  Tap(1, 500);                          // menu, then down to Stop Watch
+  for(int i = 0; i < 3; i++){
+    Tap(2, 500);
+  }
+  Tap(1, 500);
+  Check("in the stopwatch", phase_num == 4);
+  swStart = Sim_Now;
+  Tap(1, 1000);                         // Start
+
+  while(Sim_Now - swStart < (uint64_t)DAY*SIM_HZ){
+    Run(1000);
+    if(inAlarm){                        // 8:47 comes round twice a day
+      Tap(4, 0);
+      alarms++;
+    }
+    lag = Expected(start) - time;
+    if(lag < -1) lag += 43200;          // the dial turned over in between
+    if(lag < 0) ahead++;
+    if(lag > maxLag) maxLag = lag;
+  }
+  swStop = Sim_Now;
+  Tap(1, 500);                          // stop
+  elapsed = (uint32_t)((swStop - swStart)/(SIM_HZ/1000));
+  memcpy(Shown, ST7735_Frame, sizeof(Shown));
+  Digits_OutTimer(time_sw, SW_ROW);     // what those digits look like
+
+  printf("  %u alarms silenced, clock at most %d s behind the timebase\n",
+         (unsigned)alarms, maxLag);
+  printf("  stopwatch %u ms for %u ms between the taps, %u low word wraps\n",
+         (unsigned)time_sw, (unsigned)elapsed, (unsigned)Wraps);
+  Check("timebase never went back", Backwards == 0);
+  Check("low word wrapped every 53.7 s", Wraps >= ((uint64_t)DAY*SIM_HZ) >> 32);
+  Check("clock never ahead of the timebase", ahead == 0);
+  Check("clock never more than 1 s behind", maxLag <= 1);
+  Check("stopwatch still on screen", phase_num == 4);
+  Check("stopwatch reads the day to the ms", (time_sw + LATENCY >= elapsed) &&
+        (time_sw <= elapsed + LATENCY));
+  Check("and shows it", memcmp(Shown, ST7735_Frame, sizeof(Shown)) == 0);
+  return Check_Exit();
+}
@@ -0,0 +1,143 @@
+// -------------------------------------------------------------------
+// File name: Fifo.c
+// Description: AddIndexFifo throughput and stress. Moves strings the
+//              size UART_OutString and ESP8266_OutString send through a
+//              byte FIFO one Put/Get at a time and with PutN/GetN and
+//              reports bytes per ns on the host. Then a producer and a
+//              consumer thread hammer one FIFO with single and bulk calls
+//              of random sizes for two seconds, standing in for main and
+//              an interrupt, and every element must come out once and in
+//              order. FIFO_BARRIER only orders the compiler, as on the
+//              single Cortex-M4; x86-64 does not reorder stores either,
+//              so the threads see what an ISR would.
+//------------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdio.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include "Sim.h"
+#include "Fifo.h"
+#include "Check.h"
+
+#define STRING   40             // a typical outbound batch, bytes
+#define ROUNDS   2000000
+#define STRESS_S 2              // seconds the threads run
+
+AddIndexFifo(Byte, 64, uint8_t, 1, 0)
+AddIndexFifo(Word, 64, uint32_t, 1, 0)
+
+static volatile uint32_t Sink;  // keeps the timed loops from being dropped
+
+
+//------------------------------- throughput -----------------------------------
+static void Throughput(void){
+  uint8_t in[STRING], out[STRING];
+  uint64_t t0, t1, t2;
+  uint32_t same = 1;
+  for(int i = 0; i < STRING; i++){
+    in[i] = 'A' + i%26;
+  }
+  ByteFifo_Init();
+  t0 = Sim_HostNs();
+  for(int r = 0; r < ROUNDS; r++){
+    for(int i = 0; i < STRING; i++){
+      ByteFifo_Put(in[i]);
+    }
+    for(int i = 0; i < STRING; i++){
+      ByteFifo_Get(&out[i]);
+    }
+    Sink += out[r%STRING];
+  }
+  t1 = Sim_HostNs();
+  for(int r = 0; r < ROUNDS; r++){
+    ByteFifo_PutN(in, STRING);          // wraps every other round or so
+    ByteFifo_GetN(out, STRING);
+    Sink += out[r%STRING];
+  }
+  t2 = Sim_HostNs();
+  for(int i = 0; i < STRING; i++){
+    same &= in[i] == out[i];
+  }
+  printf("throughput, %d byte strings through a 64 byte FIFO\n", STRING);
+  printf("  single Put/Get %.2f bytes/ns, PutN/GetN %.2f bytes/ns, %.1f times\n",
+         (double)ROUNDS*STRING/(t1 - t0), (double)ROUNDS*STRING/(t2 - t1),
+         (double)(t1 - t0)/(t2 - t1));
+  Check("bulk copies are faster than one call per byte", (t2 - t1) < (t1 - t0));
+  Check("bulk copies keep the bytes in order across the wrap", same && (ByteFifo_Size() == 0));
+}
+
+//------------------------------- stress ---------------------------------------
+static uint32_t Lost, Full, Empty;
+static volatile int Stop;
+static volatile uint32_t Produced = 0xFFFFFFFF;   // total, once the producer stopped
+
+static void *Producer(void *arg){
+  (void)arg;
+  uint32_t next = 0, seed = 1, buf[64];
+  while(!Stop){
+    uint32_t n = 1 + RandomBelow(&seed, 48);
+    if(RandomBelow(&seed, 2)){
+      for(uint32_t k = 0; k < n; k++){
+        buf[k] = next + k;
+      }
+      n = WordFifo_PutN(buf, n);
+    } else{
+      n = WordFifo_Put(next) ? 1 : 0;
+    }
+    if(n == 0){
+      Full++;
+      sched_yield();            // let the other side in on a single core
+    }
+    next += n;
+  }
+  Produced = next;
+  return 0;
+}
+
+static void *Consumer(void *arg){
+  (void)arg;
+  uint32_t expect = 0, seed = 2, buf[64], v;
+  while(expect != Produced){
+    uint32_t n;
+    if(RandomBelow(&seed, 2)){
+      n = WordFifo_GetN(buf, 1 + RandomBelow(&seed, 48));
+      for(uint32_t k = 0; k < n; k++){
+        if(buf[k] != expect + k) Lost++;
+      }
+    } else{
+      n = WordFifo_Get(&v) ? 1 : 0;
+      if(n && (v != expect)) Lost++;
+    }
+    if(n == 0){
+      Empty++;
+      sched_yield();
+    }
+    expect += n;
+  }
+  return 0;
+}
+
+static void Stress(void){
+  pthread_t p, c;
+  struct timespec run = {STRESS_S, 0};
+  WordFifo_Init();
+  pthread_create(&c, 0, &Consumer, 0);
+  pthread_create(&p, 0, &Producer, 0);
+  nanosleep(&run, 0);
+  Stop = 1;
+  pthread_join(p, 0);
+  pthread_join(c, 0);
+  printf("stress, producer and consumer threads\n");
+  printf("  %u elements in %d s, found it full %u times and empty %u times\n",
+         (unsigned)Produced, STRESS_S, (unsigned)Full, (unsigned)Empty);
+  Check("both sides ran into the other", (Full > 0) && (Empty > 0));
+  Check("every element once and in order", Lost == 0);
+  Check("nothing left over", WordFifo_Size() == 0);
+}
+
+int main(void){
+  Throughput();
+  Stress();
+  return Check_Exit();
+}
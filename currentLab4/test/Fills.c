@@ -0,0 +1,156 @@
+// -------------------------------------------------------------------
+// File name: Fills.c
+// Description: What the display's bulk writes cost. Each fill size is sent
+//              once by the CPU, through a port that keeps the SPI busy for
+//              every byte as SsiPixels does, and once by Fill_Start with
+//              uDMA channel 11, and the two must send the same bytes. For
+//              each it prints the window and pixel bytes, the CPU time and
+//              the time until the fill is on the wire. Then the phase 1 and
+//              phase 2 screens' strings are drawn both ways: one address
+//              window per character cell through ST7735_DrawString, as the
+//              menus did, and one window per line through Text_DrawString,
+//              with the command and data bytes each redraw sends. Both
+//              must leave the same pixels.
+//------------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "Sim.h"
+#include "ST7735.h"
+#include "Fill.h"
+#include "Text.h"
+#include "Check.h"
+
+#define WINDOW    11            // CASET, RASET, RAMWR and their 8 parameters
+#define DMA_MAX   1024          // pixels a uDMA request, as in Fill.c
+#define US(c)     ((double)(c)/(SIM_HZ/1000000))
+
+//------------------------------- CPU port -------------------------------------
+static uint32_t CpuBytes;
+
+static void CpuCommand(uint8_t c){
+  (void)c;
+  CpuBytes++;
+  Sim_Spend(SIM_SPI_BYTE);
+}
+
+static void CpuPixels(uint16_t color, uint32_t n){
+  (void)color;
+  CpuBytes += 2*n;
+  Sim_Spend(2ull*n*SIM_SPI_BYTE);
+}
+
+static const fill_port_t Cpu = {&CpuCommand, &CpuCommand, &CpuPixels, 0};
+
+//------------------------------- fills ----------------------------------------
+typedef struct fill_size_t {
+  const char *what;
+  int16_t w, h;
+} fill_size_t;
+
+static const fill_size_t Sizes[] = {
+  {"pixel", 1, 1}, {"character cell", 6, 8}, {"\"WiFi...\" erase", 42, 8},
+  {"11 character line", 66, 8}, {"clock face", 80, 80}, {"screen", 128, 160}
+};
+#define SIZES (sizeof(Sizes)/sizeof(Sizes[0]))
+
+static uint64_t DoneAt;
+
+static void Done(void){
+  DoneAt = Sim_Now;
+}
+
+//------------------------------- strings --------------------------------------
+typedef struct text_t {
+  int col, row;
+  const char *text;
+} text_t;
+
+static const text_t Phase1[] = {
+  {6, 4, "Set Clock"}, {6, 6, "Set Alarm"}, {6, 8, "Back"}, {6, 10, "Stop Watch"}
+};
+static const text_t Phase2[] = {
+  {8, 8, "Set"}, {8, 10, "Back"}, {6, 6, "08"}, {9, 6, "45"}, {12, 6, "35"},
+  {8, 6, ":"}, {11, 6, ":"}
+};
+
+static uint16_t Expect[ST7735_TFTHEIGHT][ST7735_TFTWIDTH];
+
+typedef struct cost_t {
+  uint32_t windows, command, data;
+} cost_t;
+
+static void Redraw(const text_t *t, int n, int lines, cost_t *c){
+  uint32_t windows = ST7735_Windows, bytes = ST7735_Bytes;
+  memset(ST7735_Frame, 0, sizeof(ST7735_Frame));
+  for(int i = 0; i < n; i++){
+    if(lines){
+      Text_DrawString(6*t[i].col, 10*t[i].row, t[i].text, ST7735_WHITE, ST7735_BLACK);
+    } else{
+      ST7735_DrawString(t[i].col, t[i].row, (char *)t[i].text, ST7735_WHITE);
+    }
+  }
+  c->windows = ST7735_Windows - windows;
+  c->command = WINDOW*c->windows;
+  c->data = ST7735_Bytes - bytes - c->command;
+}
+
+static int Strings(const char *name, const text_t *t, int n){
+  cost_t before, after;
+  Redraw(t, n, 0, &before);
+  memcpy(Expect, ST7735_Frame, sizeof(Expect));
+  Redraw(t, n, 1, &after);
+  printf("  %-8s %4u %5u %6u   %4u %5u %6u\n", name, (unsigned)before.windows,
+         (unsigned)before.command, (unsigned)before.data, (unsigned)after.windows,
+         (unsigned)after.command, (unsigned)after.data);
+  return (memcmp(Expect, ST7735_Frame, sizeof(Expect)) == 0) &&
+         (after.command < before.command) && (after.data <= before.data);
+}
+
+int main(void){
+  int same = 1, faster = 1, onWire = 1;
+  printf("Fills by size, CPU against uDMA (us at %d MHz)\n", SIM_HZ/1000000);
+  Sim_Init();
+  Output_Init();
+  printf("  %-18s %6s %6s %9s %9s %9s %4s\n", "fill", "window", "pixels", "CPU",
+         "uDMA CPU", "uDMA done", "reqs");
+  for(uint32_t i = 0; i < SIZES; i++){
+    const fill_size_t *s = &Sizes[i];
+    uint32_t n = s->w*s->h;
+    uint64_t t0, cpu, dma, cpuDma, done;
+    Fill_Init(&Cpu);
+    CpuBytes = 0;
+    t0 = Sim_Now;
+    Fill_Rect(0, 0, s->w, s->h, ST7735_BLUE);
+    cpu = Sim_Now - t0;
+
+    Fill_Init(0);
+    dma = Sim_DmaCycles;
+    t0 = Sim_Now;
+    Fill_Start(0, 0, s->w, s->h, ST7735_BLUE, &Done);
+    // SsiCommand waits out each command and its parameters; the host SSI0
+    // is never busy, so the window's bytes are charged here
+    cpuDma = Sim_Now - t0 + WINDOW*SIM_SPI_BYTE;
+    while(Fill_Busy()){
+      Sim_Run(Sim_Now + SIM_SPI_BYTE);
+    }
+    done = DoneAt - t0 + WINDOW*SIM_SPI_BYTE;
+    dma = Sim_DmaCycles - dma;
+    printf("  %-18s %6d %6u %9.1f %9.1f %9.1f %4u\n", s->what, WINDOW, 2*n, US(cpu),
+           US(cpuDma), US(done), (unsigned)((n + DMA_MAX - 1)/DMA_MAX));
+    same &= (CpuBytes == WINDOW + 2*n) && (dma == 2ull*n*SIM_SPI_BYTE);
+    onWire &= done == cpu;
+    faster &= cpuDma < cpu;
+  }
+  Check("same bytes by CPU and by uDMA", same);
+  Check("uDMA fill on the wire as soon as the CPU's", onWire);
+  Check("uDMA takes less CPU time at every size", faster);
+
+  printf("Menu redraws, cell by cell against line by line\n");
+  printf("  %-8s %18s   %18s\n", "", "ST7735_DrawString", "Text_DrawString");
+  printf("  %-8s %4s %5s %6s   %4s %5s %6s\n", "screen", "win", "cmd", "data",
+         "win", "cmd", "data");
+  Check("phase 1 same pixels in fewer command bytes", Strings("phase 1", Phase1, 4));
+  Check("phase 2 same pixels in fewer command bytes", Strings("phase 2", Phase2, 7));
+  return Check_Exit();
+}
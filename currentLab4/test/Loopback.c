@@ -0,0 +1,265 @@
+// -------------------------------------------------------------------
+// File name: Loopback.c
+// Description: Round trips over the TM4C-ESP8266 link. First the two
+//              record formats alone: every value survives CSV and binary
+//              encoding, a flipped bit is caught by the binary CRC, and
+//              the bytes and host time per record of each, the mean over
+//              a mix of records and the slowest single record. Then the
+//              firmware is booted against the loopback ESP8266, run with
+//              the argument csv for a module that only knows CSV lines:
+//              the app's writes must reach the VP handlers, the clock must
+//              reach the app, and the bytes on the wire are counted. With
+//              binary records, damaged ones are dropped and four in a row
+//              fall back to CSV.
+//------------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "Sim.h"
+#include "esp8266.h"
+#include "Frame.h"
+#include "Check.h"
+
+#define RXSLOTSIZE 64           // as in Blynk.c
+#define VP_FRAMING 98
+
+// Blynk.c
+int Blynk_main(void);
+int Blynk_Parse(const char *pt, uint32_t *pin, uint32_t *integer, int32_t *fixed);
+char *FormatUDec(char *pt, uint32_t n);
+extern volatile int FrameBinary;
+extern uint32_t FrameBad, AlarmMelody, LED;
+extern uint8_t phase_num;
+extern int time;
+
+static uint32_t Seed = 7;
+static volatile uint32_t Sink;  // keeps the timed loops from being dropped
+
+
+// the CSV line TM4C_to_Blynk writes, with a null
+static uint32_t Csv(char *line, uint32_t pin, uint32_t value){
+  char *pt = FormatUDec(line, pin);
+  *pt++ = ',';
+  pt = FormatUDec(pt, value);
+  strcpy(pt, ",0.0\n");
+  return strlen(line);
+}
+
+static uint32_t Binary(char *line, uint32_t pin, uint32_t value){
+  char *pt = Frame_Encode(line, pin, value);
+  *pt = 0;
+  return pt - line;
+}
+
+// host ns to check and unpack one record, the best of three runs of a
+// batch so a preempted run does not count as a slow record
+#define BATCH 20000
+static double Timed(const char *line, int binary){
+  uint32_t pin, v;
+  int32_t fixed;
+  double best = 1e9;
+  for(int run = 0; run < 3; run++){
+    uint64_t t0 = Sim_HostNs();
+    for(int i = 0; i < BATCH; i++){
+      if(binary){
+        Frame_Decode(line, RXSLOTSIZE, &pin, &v);
+      } else{
+        Blynk_Parse(line, &pin, &v, &fixed);
+      }
+      Sink += v;
+    }
+    double ns = (double)(Sim_HostNs() - t0)/BATCH;
+    if(ns < best) best = ns;
+  }
+  return best;
+}
+
+//------------------------------- records --------------------------------------
+#define VALUES 2000
+static void Records(void){
+  static const uint32_t edge[] = {0, 1, '\n', 0x1B, 59, 127, 128, 255, 16383, 16384,
+                                  43199, 1u << 21, 0x7FFFFFFF, 0xFFFFFFFF};
+  char line[RXSLOTSIZE];
+  uint32_t value[VALUES], pin, v, bad = 0, stuffed = 0, clean = 0, caught = 0, missed = 0;
+  uint32_t csvBytes = 0, binBytes = 0, flips = 0, csvWrong = 0;
+  int32_t fixed;
+  uint64_t t0, t1, t2;
+  double worst[2] = {0, 0};
+  uint32_t worstValue[2] = {0, 0};
+  for(int i = 0; i < VALUES; i++){
+    value[i] = (i < (int)(sizeof(edge)/4)) ? edge[i] : Random(&Seed) >> (Random(&Seed)%32);
+  }
+  for(int i = 0; i < VALUES; i++){
+    uint32_t p = i%100, n;
+    memset(line, 0, sizeof(line));
+    Csv(line, p, value[i]);
+    if(!Blynk_Parse(line, &pin, &v, &fixed) || (pin != p) || (v != value[i])) bad++;
+    memset(line, 0, sizeof(line));
+    n = Binary(line, p, value[i]);
+    if(!Frame_Decode(line, sizeof(line), &pin, &v) || (pin != p) || (v != value[i])) bad++;
+    if((memchr(line, '\n', n) != line + n - 1) || (n > FRAME_MAX)) clean++;
+    if(memchr(line, 0x1B, n)) stuffed++;
+  }
+  // the clock fields the TM4C sends most: VP74-76 over a 12 hour dial
+  for(int t = 0; t < 43200; t++){
+    uint32_t f[3] = {t/3600, (t%3600)/60, t%60};
+    for(int k = 0; k < 3; k++){
+      csvBytes += Csv(line, 74 + k, f[k]);
+      binBytes += Binary(line, 74 + k, f[k]);
+    }
+  }
+  // every single bit error in a sample of records
+  for(int i = 0; i < 200; i++){
+    char good[RXSLOTSIZE];
+    uint32_t n;
+    memset(good, 0, sizeof(good));
+    n = Binary(good, i%100, value[i]);
+    for(uint32_t b = 0; b < 8*(n - 1); b++){
+      memcpy(line, good, sizeof(line));
+      line[b/8] ^= 1 << (b%8);
+      if(Frame_Decode(line, sizeof(line), &pin, &v)){
+        missed++;
+      } else{
+        caught++;
+      }
+    }
+    memset(good, 0, sizeof(good));
+    n = Csv(good, i%100, value[i]);
+    for(uint32_t b = 0; b < 8*(n - 1); b++){
+      memcpy(line, good, sizeof(line));
+      line[b/8] ^= 1 << (b%8);
+      flips++;
+      if(Blynk_Parse(line, &pin, &v, &fixed) && ((pin != (uint32_t)i%100) || (v != value[i]))){
+        csvWrong++;
+      }
+    }
+  }
+  // host time to check and unpack one record of each format
+  {
+    static char csv[64][RXSLOTSIZE], bin[64][RXSLOTSIZE];
+    for(int i = 0; i < 64; i++){
+      memset(csv[i], 0, RXSLOTSIZE);
+      memset(bin[i], 0, RXSLOTSIZE);
+      Csv(csv[i], i%10, value[i + 100] % 43200);
+      Binary(bin[i], i%10, value[i + 100] % 43200);
+    }
+    t0 = Sim_HostNs();
+    for(int i = 0; i < 1000000; i++){
+      Blynk_Parse(csv[i & 63], &pin, &v, &fixed);
+      Sink += v;
+    }
+    t1 = Sim_HostNs();
+    for(int i = 0; i < 1000000; i++){
+      Frame_Decode(bin[i & 63], RXSLOTSIZE, &pin, &v);
+      Sink += v;
+    }
+    t2 = Sim_HostNs();
+  }
+  // the slowest single record: every edge value and a sample of the rest,
+  // on the two-digit pins
+  {
+    char csv[RXSLOTSIZE], bin[RXSLOTSIZE];
+    for(int i = 0; i < 64; i++){
+      memset(csv, 0, RXSLOTSIZE);
+      memset(bin, 0, RXSLOTSIZE);
+      Csv(csv, 90 + i%10, value[i]);
+      Binary(bin, 90 + i%10, value[i]);
+      for(int k = 0; k < 2; k++){
+        double ns = Timed(k ? bin : csv, k);
+        if(ns > worst[k]){
+          worst[k] = ns;
+          worstValue[k] = value[i];
+        }
+      }
+    }
+  }
+  printf("records\n");
+  printf("  %d values round tripped, %u binary records stuffed\n", VALUES, (unsigned)stuffed);
+  printf("  clock fields VP74-76: CSV %.2f bytes, binary %.2f bytes a record\n",
+         csvBytes/(3*43200.0), binBytes/(3*43200.0));
+  printf("  single bit errors: binary %u caught, %u missed; CSV %u of %u parsed to a wrong value\n",
+         (unsigned)caught, (unsigned)missed, (unsigned)csvWrong, (unsigned)flips);
+  printf("  host ns to parse: Blynk_Parse mean %.1f, max %.1f (value %u)\n",
+         (t1 - t0)/1e6, worst[0], (unsigned)worstValue[0]);
+  printf("                    Frame_Decode mean %.1f, max %.1f (value %u)\n",
+         (t2 - t1)/1e6, worst[1], (unsigned)worstValue[1]);
+  Check("every value survives both formats", bad == 0);
+  Check("binary records have one '\\n', at the end", clean == 0);
+  Check("binary clock fields under 60% of the CSV bytes", 5*binBytes < 3*csvBytes);
+  Check("CRC-8 catches every single bit error", missed == 0);
+}
+
+//------------------------------- firmware -------------------------------------
+static void Run(uint32_t ms){
+  Sim_Run(Sim_Now + (uint64_t)ms*(SIM_HZ/1000));
+}
+
+static void Link(uint32_t frames){
+  uint32_t tx, records, rx, shown;
+  char line[RXSLOTSIZE];
+  printf("link, %s module\n", frames ? "binary" : "CSV only");
+  Sim_Init();
+  Loopback_Init(frames);
+  Sim_Boot(&Blynk_main);
+  Run(20000);
+  Check("link up", Loopback_Up);
+  Check("offered binary records on VP98", Loopback_Value[VP_FRAMING] == 1);
+  Check(frames ? "module answers in binary" : "module stays on CSV", Loopback_Binary == (int)frames);
+
+  rx = Loopback_RxBytes;
+  Loopback_Write(8, 2);                 // melody
+  Loopback_Write(1, 1);                 // select, into the menu
+  Loopback_Write(1, 0);
+  Run(1000);
+  printf("  from the app: %u bytes for 3 writes\n", (unsigned)(Loopback_RxBytes - rx));
+  Check("app writes reached the VP handlers", (AlarmMelody == 2) && (phase_num == 1));
+  Check(frames ? "TM4C took up binary records" : "TM4C stays on CSV", FrameBinary == (int)frames);
+
+  tx = Loopback_TxBytes;
+  records = Loopback_Records;
+  Run(60000);                           // the menu times out meanwhile
+  shown = 3600*Loopback_Value[74] + 60*Loopback_Value[75] + Loopback_Value[76];
+  printf("  60 s of clock: %u records to the app, %.2f bytes each, %.1f bytes/s\n",
+         (unsigned)(Loopback_Records - records),
+         (double)(Loopback_TxBytes - tx)/(Loopback_Records - records),
+         (Loopback_TxBytes - tx)/60.0);
+  Check("the app shows the clock within a second", (uint32_t)(time - shown) <= 1);
+  Check("app parsed every record", Loopback_Bad == 0);
+  if(frames){
+    Check("binary records under 6 bytes", (Loopback_TxBytes - tx) < 6*(Loopback_Records - records));
+    *Frame_Encode(line, 1, 1) = 0;
+    line[strlen(line) - 2] ^= 0x01;     // damage the CRC
+    for(int i = 0; i < 3; i++){
+      Loopback_Line(line);
+    }
+    Run(1000);
+    Check("damaged records dropped, still binary", (LED == 0) && (phase_num == 0) &&
+          (FrameBad == 3) && FrameBinary);
+    Loopback_Write(1, 0);
+    Run(100);
+    Check("a good record clears the count", FrameBad == 0);
+    for(int i = 0; i < 4; i++){
+      Loopback_Line(line);
+    }
+    Run(1000);
+    Check("four damaged in a row fall back to CSV", FrameBinary == 0);
+    tx = Loopback_TxBytes;
+    records = Loopback_Records;
+    Run(2000);
+    Check("and the TM4C sends CSV again", (Loopback_TxBytes - tx) >= 8*(Loopback_Records - records));
+  } else{
+    Check("CSV records under 11 bytes", (Loopback_TxBytes - tx) < 11*(Loopback_Records - records));
+    Loopback_Line("1,x,\n");
+    Run(100);
+    Check("a garbled line is ignored", (LED == 0) && (phase_num == 0));
+  }
+}
+
+int main(int argc, char **argv){
+  uint32_t frames = !((argc > 1) && (strcmp(argv[1], "csv") == 0));
+  if(frames){
+    Records();
+  }
+  Link(frames);
+  return Check_Exit();
+}
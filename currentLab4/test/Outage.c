@@ -0,0 +1,84 @@
+// -------------------------------------------------------------------
+// File name: Outage.c
+// Description: Boots the firmware with the loopback ESP8266, lets the link
+//              come up, then takes the Blynk server away for ten minutes.
+//              The alarm at 8:47 and the 8:50 clock sample are logged to
+//              the history ring during the outage. The firmware must notice
+//              the module raising RDY, keep the records, reset and set up
+//              the module until the server is back, and then drain the
+//              ring so every record reaches the app exactly once.
+//------------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdio.h>
+#include "Sim.h"
+#include "esp8266.h"
+#include "History.h"
+#include "Check.h"
+
+#define VP_HISTORY  93          // as in Blynk.c
+#define OUTAGE_MS   600000
+#define RUN_MS      1800000     // half an hour, 8:45:35 to 9:15:35
+#define ALARM_AT    (8*3600 + 47*60)
+
+// Blynk.c
+int Blynk_main(void);
+extern int inAlarm;
+extern uint32_t LinkRetries, LinkDrops;
+
+static uint32_t Held;           // most records waiting while the server was away
+
+static void Run(uint32_t ms){
+  Sim_Run(Sim_Now + (uint64_t)ms*(SIM_HZ/1000));
+}
+
+static void Holding(void){
+  if(!Loopback_Up && (History_Size() > Held)){
+    Held = History_Size();
+  }
+}
+
+int main(void){
+  uint64_t back, rejoined = 0;
+  printf("History across a %d minute outage\n", OUTAGE_MS/60000);
+  Sim_Init();
+  Loopback_Init(LOOP_FRAMES);
+  Sim_Watch(&Holding);
+  Sim_Boot(&Blynk_main);
+  Run(20000);
+  Check("link up", Loopback_Up);
+  Check("boot record uploaded", Loopback_Count[VP_HISTORY + HIST_BOOT] == 1);
+
+  Run(40000);
+  Loopback_Drop(OUTAGE_MS);
+  back = Sim_Now + (uint64_t)OUTAGE_MS*(SIM_HZ/1000);
+  for(uint32_t ms = 60000; ms < RUN_MS; ms += 1000){
+    Run(1000);
+    if(Loopback_Up && !rejoined && (Sim_Now > back)){
+      rejoined = Sim_Now;
+    }
+    if(inAlarm && Loopback_Up){
+      Loopback_Write(4, 1);             // silence it once the app can
+      Loopback_Write(4, 0);
+    }
+  }
+  printf("  %u records held while away, link back %.1f s after the server",
+         (unsigned)Held, rejoined ? (double)(rejoined - back)/SIM_HZ : -1.0);
+  printf(", %u resets\n", (unsigned)LinkRetries);
+  printf("  uploaded: boot %u, alarm %u at %u, samples %u, %u left, %u dropped\n",
+         (unsigned)Loopback_Count[VP_HISTORY + HIST_BOOT],
+         (unsigned)Loopback_Count[VP_HISTORY + HIST_ALARM],
+         (unsigned)Loopback_Value[VP_HISTORY + HIST_ALARM],
+         (unsigned)Loopback_Count[VP_HISTORY + HIST_SAMPLE],
+         (unsigned)History_Size(), (unsigned)History_Dropped);
+  Check("one outage seen", LinkDrops == 1);
+  Check("records held in the ring while away", Held >= 2);
+  Check("link back once the server is", rejoined != 0);
+  Check("and binary records offered again", Loopback_Binary);
+  Check("alarm record reached the app once",
+        (Loopback_Count[VP_HISTORY + HIST_ALARM] == 1) &&
+        (Loopback_Value[VP_HISTORY + HIST_ALARM] == ALARM_AT));
+  Check("8:50, 9:00 and 9:10 samples reached the app once",
+        Loopback_Count[VP_HISTORY + HIST_SAMPLE] == 3);
+  Check("ring drained, nothing overwritten", (History_Size() == 0) && (History_Dropped == 0));
+  return Check_Exit();
+}
@@ -0,0 +1,131 @@
+// -------------------------------------------------------------------
+// File name: Settings.c
+// Description: The settings log on the host EEPROM stand-in. Saves are
+//              logged past the end of the store several times over, and
+//              after each one a fresh restore must find the newest record
+//              with the binary search, reading a handful of words and not
+//              the whole log. A write torn after any number of its words
+//              must restore the record before it, and the next save must
+//              take its slot. Bursts of edits, polled once a second as
+//              ClockTick does, must each cost one record. Prints the words
+//              and time a restore reads and the words written per save.
+//------------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdio.h>
+#include "Sim.h"
+#include "Eeprom.h"
+#include "Settings.h"
+#include "Check.h"
+
+#define RECWORDS  5             // as in Settings.c
+#define SLOTS     (EEPROM_WORDS/RECWORDS)
+#define LOGGED    (3*SLOTS + 7) // records, round the store three times
+#define BURSTS    200
+#define BURST     6             // edits in a burst, a second apart
+
+static uint32_t Seed = 16;
+
+static settings_t Make(uint32_t n){
+  settings_t s;
+  s.alarm = (int32_t)(n%43200);
+  s.phase = (n%3 == 0) ? 0 : (n%3 == 1) ? 5 : 6;
+  s.stopwatch = n*1000 + 7;
+  return s;
+}
+
+static int Same(const settings_t *a, const settings_t *b){
+  return (a->alarm == b->alarm) && (a->phase == b->phase) &&
+         (a->stopwatch == b->stopwatch);
+}
+
+// save s and poll until it is written
+static int Write(const settings_t *s){
+  Settings_Save(s);
+  for(int i = 0; i < SETTINGS_QUIET; i++){
+    if(Settings_Poll()){
+      return 1;
+    }
+  }
+  return 0;
+}
+
+// restore as a reset would, 1 if it brought back expect
+static int Restore(const settings_t *expect, uint64_t *cycles){
+  settings_t s = Make(0xFFFF);
+  uint64_t start = Sim_Now;
+  int found = Settings_Init(&Eeprom_Storage, &s);
+  if(cycles){
+    *cycles = Sim_Now - start;
+  }
+  return found && Same(&s, expect);
+}
+
+int main(void){
+  settings_t s, last;
+  uint32_t restored = 0, maxReads = 0, torn = 0, reused = 0, records, written, requests;
+  uint64_t cycles, maxCycles = 0, saveCycles;
+  printf("Settings log on a %d word store, %d slots\n", EEPROM_WORDS, SLOTS);
+  Sim_Init();
+  Eeprom_Init();
+  s = Make(1);
+  Check("an erased store restores nothing", !Settings_Init(&Eeprom_Storage, &s) &&
+        Same(&s, &(settings_t){1, 5, 1007}));
+
+  // the full log and its wrap-around, restored after every record
+  for(uint32_t n = 0; n < LOGGED; n++){
+    last = Make(n + 2);
+    Write(&last);
+    restored += Restore(&last, &cycles);
+    if(Settings_RestoreReads > maxReads) maxReads = Settings_RestoreReads;
+    if(cycles > maxCycles) maxCycles = cycles;
+  }
+  printf("  %u records logged, a restore reads at most %u words in %.1f us\n",
+         (unsigned)LOGGED, (unsigned)maxReads, (double)maxCycles/(SIM_HZ/1000000));
+  Check("every restore finds the newest record", restored == LOGGED);
+  Check("and reads no more than the search and one record",
+        maxReads <= 8 + RECWORDS + RECWORDS);
+
+  // a reset part way through the newest record, at each word
+  for(int32_t cut = 0; cut < RECWORDS; cut++){
+    for(uint32_t k = 0; k < SLOTS + 3; k += SLOTS/4 + 1){   // all over the store
+      settings_t next = Make(9000 + k);
+      Eeprom_Tear = cut;
+      Write(&next);
+      torn += Restore(&last, 0);
+      last = Make(9100 + k);
+      Write(&last);
+      reused += Restore(&last, 0);
+    }
+  }
+  Check("a torn record restores the one before it", torn == RECWORDS*5);
+  Check("and the next save takes its place", reused == RECWORDS*5);
+
+  // bursts of edits a second apart, then quiet
+  records = Settings_Records;
+  requests = Settings_Requests;
+  written = Eeprom_WordsWritten;
+  saveCycles = Sim_Now;
+  for(int b = 0; b < BURSTS; b++){
+    for(int e = 0; e < BURST; e++){
+      s = Make(20000 + RandomBelow(&Seed, 20000));
+      Settings_Save(&s);
+      Settings_Poll();
+    }
+    for(int q = 0; q < SETTINGS_QUIET; q++){
+      Settings_Poll();
+    }
+  }
+  records = Settings_Records - records;
+  requests = Settings_Requests - requests;
+  written = Eeprom_WordsWritten - written;
+  saveCycles = Sim_Now - saveCycles;
+  printf("  %u saves in %d bursts wrote %u records, %u words, %.1f words a save\n",
+         (unsigned)requests, BURSTS, (unsigned)records, (unsigned)written,
+         (double)written/requests);
+  printf("  %.0f us of EEPROM programming a burst\n",
+         (double)saveCycles/BURSTS/(SIM_HZ/1000000));
+  Check("one record a burst", records == BURSTS);
+  Check("five words a record", written == RECWORDS*records);
+  Check("the last burst restores", Restore(&s, 0));
+  return Check_Exit();
+}
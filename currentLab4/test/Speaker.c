@@ -0,0 +1,159 @@
+// -------------------------------------------------------------------
+// File name: Speaker.c
+// Description: Renders the alarm melodies offline through Speaker_Sample,
+//              one sample per Timer1A interrupt at 8 kHz, into a PCM
+//              buffer. Every note must be on pitch, counted from its
+//              rising crossings of the midpoint, and every rest silent.
+//              Each note's envelope must rise over the 5 ms attack, then
+//              decay by 1/2048 a sample and never grow again. Times the
+//              sample routine on this PC, the mean and the 99.9th
+//              percentile of batches of 64, against the ISR's 400 cycle
+//              (5 us) budget in the 125 us period.
+//              Given a file name, writes the beeps as an 8-bit WAV.
+//------------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "Sim.h"
+#include "Speaker.h"
+#include "Check.h"
+
+#define SAMPLE_RATE   8000      // as in Speaker.c
+#define SAMPLE_BUDGET 400
+#define ATTACK        40
+#define ENV_MAX       32767
+#define SIXTEENTH     (SAMPLE_RATE/16)
+#define WINDOW        40        // samples a peak is taken over
+#define SAMPLES       (2*14*SIXTEENTH*4)
+#define BATCH         64        // samples timed together
+#define BATCHES       16384
+
+typedef struct note_t {
+  int melody;
+  uint32_t start, sixteenths;   // in the rendered melody
+  double hz;                    // 0 for a rest
+} note_t;
+
+static const note_t Notes[] = {
+  {0,     0,  2, 2093.0}, {0,  1000,  2, 0}, {0, 2000, 2, 2093.0}, {0, 5000, 10, 0},
+  {0, 10000,  2, 2093.0},                       // round again
+  {1,     0,  4, 1046.5}, {1,  2000,  4, 1318.5}, {1, 4000, 4, 1568.0},
+  {1,  6000,  8, 2093.0}, {1, 10000, 12, 0},
+  {2,     0,  4, 1318.5}, {2,  6000,  8, 784.0}, {2, 10000, 4, 0}
+};
+#define NOTES (sizeof(Notes)/sizeof(Notes[0]))
+
+static uint8_t Pcm[3][SAMPLES];
+static uint64_t Batch[BATCHES];   // host ns
+
+static int Compare(const void *a, const void *b){
+  uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+  return (x > y) - (x < y);
+}
+
+static double Pitch(const uint8_t *s, uint32_t n){
+  int first = -1, last = -1, rising = 0;
+  for(uint32_t i = 1; i < n; i++){
+    if((s[i-1] < 128) && (s[i] >= 128)){
+      if(first < 0) first = i;
+      last = i;
+      rising++;
+    }
+  }
+  return (rising > 1) ? (double)(rising - 1)*SAMPLE_RATE/(last - first) : 0;
+}
+
+static int Peak(const uint8_t *s, uint32_t n){
+  int peak = 0;
+  for(uint32_t i = 0; i < n; i++){
+    int a = (s[i] > 128) ? s[i] - 128 : 128 - s[i];
+    if(a > peak) peak = a;
+  }
+  return peak;
+}
+
+// rises over the attack, then only decays, at (1 - 1/2048) a sample
+static int Envelope(const uint8_t *s, uint32_t n){
+  int top = Peak(&s[ATTACK], WINDOW), prev = top;
+  int ok = Peak(s, ATTACK/2) < Peak(&s[ATTACK/2], ATTACK/2);
+  int32_t env = ENV_MAX/ATTACK*ATTACK;
+  double expect, last;
+  for(uint32_t i = ATTACK + WINDOW; i < n; i++){
+    env -= env >> 11;           // as Speaker_Sample does it
+  }
+  expect = (double)env/(ENV_MAX/ATTACK*ATTACK);
+  for(uint32_t w = ATTACK + WINDOW; w + WINDOW <= n; w += WINDOW){
+    int p = Peak(&s[w], WINDOW);
+    ok &= p <= prev + prev/25 + 1;  // sampled at another phase each window, a few % off
+    prev = p;
+  }
+  last = (double)Peak(&s[n - WINDOW], WINDOW)/top;
+  return ok && (fabs(last - expect) < 0.03);
+}
+
+static void Wav(const char *name, const uint8_t *s, uint32_t n){
+  FILE *f = fopen(name, "wb");
+  uint32_t h[] = {0x46464952, 36 + n, 0x45564157, 0x20746D66, 16, 0x00010001,
+                  SAMPLE_RATE, SAMPLE_RATE, 0x00080001, 0x61746164, n};
+  if(f == 0) return;
+  fwrite(h, sizeof(h), 1, f);
+  fwrite(s, 1, n, f);
+  fclose(f);
+}
+
+int main(int argc, char **argv){
+  int pitched = 0, tones = 0, silent = 0, rests = 0, shaped = 0;
+  uint64_t t0, total = 0;
+  double slow;
+  volatile uint32_t sink = 0;
+  printf("Alarm synthesizer, %d Hz offline render\n", SAMPLE_RATE);
+  Sim_Init();
+  for(int m = 0; m < 3; m++){
+    Speaker_Play(m);
+    for(uint32_t i = 0; i < SAMPLES; i++){
+      Pcm[m][i] = Speaker_Sample();
+    }
+  }
+  Speaker_Stop();
+  for(uint32_t k = 0; k < NOTES; k++){
+    const note_t *n = &Notes[k];
+    const uint8_t *s = &Pcm[n->melody][n->start];
+    uint32_t len = n->sixteenths*SIXTEENTH;
+    if(n->hz == 0){
+      rests++;
+      silent += (Peak(s, len) == 0);
+      continue;
+    }
+    double hz = Pitch(s, len);
+    printf("  melody %d at %5.2f s: %7.1f Hz for %7.1f Hz\n", n->melody,
+           (double)n->start/SAMPLE_RATE, hz, n->hz);
+    tones++;
+    pitched += fabs(hz - n->hz) < 0.005*n->hz;
+    shaped += Envelope(s, len);
+  }
+  Check("every note within 0.5% of its pitch", pitched == tones);
+  Check("every rest silent", silent == rests);
+  Check("every note rises, then decays at 1/2048 a sample", shaped == tones);
+
+  Speaker_Play(2);
+  for(uint32_t b = 0; b < BATCHES; b++){
+    t0 = Sim_HostNs();
+    for(int i = 0; i < BATCH; i++){
+      sink += Speaker_Sample();
+    }
+    Batch[b] = Sim_HostNs() - t0;
+    total += Batch[b];
+  }
+  Speaker_Stop();
+  qsort(Batch, BATCHES, sizeof(Batch[0]), &Compare);
+  slow = (double)Batch[BATCHES - BATCHES/1000]/BATCH;
+  printf("  host ns a sample: mean %.1f, 99.9th percentile batch %.1f;"
+         " budget %.0f ns of the %.0f ns period\n", (double)total/(BATCHES*BATCH), slow,
+         1e9*SAMPLE_BUDGET/80e6, 1e9/SAMPLE_RATE);
+  Check("sample time within the ISR budget", slow < 1e9*SAMPLE_BUDGET/80e6);
+  if(argc > 1){
+    Wav(argv[1], Pcm[0], SAMPLES);
+  }
+  return Check_Exit();
+}